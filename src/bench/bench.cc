@@ -0,0 +1,92 @@
+#include <new>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include "bench.h"
+#include "../breakout/allocations.h"
+
+namespace Bench {
+
+#ifdef BREAKOUT_TRACK_ALLOCATIONS
+    uint64_t allocations (void) { return Breakout::Allocations::count(); }
+#else
+    static std::atomic<uint64_t> count(0);
+
+    uint64_t allocations (void) { return Bench::count.load(std::memory_order_relaxed); }
+#endif
+    constexpr unsigned Runner::Samples;
+    constexpr double Runner::SampleTime;
+
+    void Runner::report (const Result &result) {
+        std::printf("%-40s %12.1f ns/op %7.1f%% %10.2f allocs/op\n", result.name.c_str(), result.ns, result.deviation * 100.0, result.allocations);
+    }
+
+    bool Runner::save (const std::string &path) const {
+
+        std::ofstream out(path);
+
+        for (const auto &result : this->results) {
+            out << result.name << '\t' << result.ns << '\t' << result.deviation << '\t' << result.allocations << '\n';
+        }
+
+        return static_cast<bool>(out);
+    }
+
+    bool Runner::compare (const std::string &path) const {
+
+        std::ifstream in(path);
+        std::unordered_map<std::string, Result> baseline;
+        std::string line;
+
+        if (!in) {
+            return false;
+        }
+
+        while (std::getline(in, line)) {
+            std::istringstream fields(line);
+            Result result;
+            if (std::getline(fields, result.name, '\t') && fields >> result.ns >> result.deviation >> result.allocations) {
+                baseline[result.name] = result;
+            }
+        }
+
+        std::printf("\n%-40s %12s %12s %8s %10s\n", "compared to baseline", "before", "after", "change", "allocs");
+
+        for (const auto &result : this->results) {
+
+            auto before = baseline.find(result.name);
+
+            if (before == baseline.end()) {
+                std::printf("%-40s %12s %12.1f\n", result.name.c_str(), "-", result.ns);
+            } else {
+                const double change = before->second.ns > 0.0 ? (result.ns - before->second.ns) / before->second.ns * 100.0 : 0.0;
+                // inside the noise of either run the change means nothing
+                const bool noise = std::abs(change) <= 100.0 * (result.deviation + before->second.deviation);
+                std::printf("%-40s %12.1f %12.1f %+7.1f%%%s %+10.2f\n",
+                    result.name.c_str(), before->second.ns, result.ns, change, noise ? "~" : " ",
+                    result.allocations - before->second.allocations);
+            }
+        }
+
+        return true;
+    }
+
+}
+
+#ifndef BREAKOUT_TRACK_ALLOCATIONS
+
+void *operator new (std::size_t size) {
+    Bench::count.fetch_add(1, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete (void *pointer) noexcept {
+    std::free(pointer);
+}
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef SRC_BENCH_BENCH_H_
+#define SRC_BENCH_BENCH_H_
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <unordered_map>
+
+namespace Bench {
+
+    // global operator new calls so far, replaced in bench.cc unless the
+    // game's own allocation tracker is built in
+    uint64_t allocations(void);
+
+    // keeps the optimizer from dropping a result
+    template <typename T>
+    inline void keep (const T &value) {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    struct Result {
+        std::string name;
+        double ns, deviation, allocations;
+    };
+
+    // Runs every benchmark in batches long enough for the clock, then reports
+    // ns/op, the deviation between batches and allocations/op.
+    class Runner {
+
+        static constexpr unsigned Samples = 15;
+        static constexpr double SampleTime = 0.01;
+
+        std::string filter;
+        std::vector<Result> results;
+
+        void report(const Result &result);
+
+    public:
+
+        static inline double now (void) {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        inline Runner (const std::string &_filter = "") : filter(_filter) {}
+
+        template <typename F>
+        inline void run (const std::string &name, F function) {
+
+            if (name.find(this->filter) == std::string::npos) {
+                return;
+            }
+
+            uint64_t iterations = 1;
+            double elapsed = 0.0;
+
+            // calibrate the batch size
+            while (true) {
+                const double start = Runner::now();
+                for (uint64_t i = 0; i < iterations; ++i) {
+                    function();
+                }
+                elapsed = Runner::now() - start;
+                if (elapsed >= Runner::SampleTime / 10.0 || iterations >= (1u << 30)) {
+                    break;
+                }
+                iterations *= 2;
+            }
+
+            iterations = std::max<uint64_t>(1, iterations * (Runner::SampleTime / std::max(elapsed, 1e-9)));
+
+            double sum = 0.0, sum_squares = 0.0;
+            const uint64_t allocations_before = Bench::allocations();
+
+            for (unsigned sample = 0; sample < Runner::Samples; ++sample) {
+                const double start = Runner::now();
+                for (uint64_t i = 0; i < iterations; ++i) {
+                    function();
+                }
+                const double ns = (Runner::now() - start) * 1e9 / iterations;
+                sum += ns;
+                sum_squares += ns * ns;
+            }
+
+            const double
+                mean = sum / Runner::Samples,
+                variance = std::max(sum_squares / Runner::Samples - mean * mean, 0.0),
+                allocations = static_cast<double>(Bench::allocations() - allocations_before) / (iterations * Runner::Samples);
+
+            this->results.push_back({ name, mean, mean > 0.0 ? std::sqrt(variance) / mean : 0.0, allocations });
+            this->report(this->results.back());
+        }
+
+        inline const std::vector<Result> &getResults (void) const { return this->results; }
+
+        bool save(const std::string &path) const;
+
+        // prints the change against a file written by save
+        bool compare(const std::string &path) const;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,231 @@
+#include <iostream>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "bench.h"
+#include "../engine/window.h"
+#include "../engine/mesh.h"
+#include "../engine/color.h"
+#include "../breakout/ball.h"
+#include "../breakout/brick.h"
+#include "../breakout/events.h"
+#include "../breakout/arena.h"
+#include "../breakout/layout.h"
+#include "../breakout/stage.h"
+#include "../breakout/generator.h"
+#include "../breakout/jobs.h"
+#include "../breakout/memory.h"
+
+// Plays generated stages of growing size for a fixed number of frames and
+// writes one CSV line per size, ready to plot against the brick count.
+static void sweep (Engine::Window &window, std::ostream &out) {
+
+    constexpr unsigned frames = 120;
+    const unsigned sides[] = { 8, 16, 32, 48, 64, 96, 128 };
+
+    out << "bricks,construct_ms,update_ms,update_max_ms,draw_ms,arena_bytes,rss_bytes" << std::endl;
+
+    for (unsigned side : sides) {
+
+        Breakout::Generator::Options options;
+        options.rows = options.columns = side;
+        options.seed = side;
+
+        const Breakout::Layout layout = Breakout::Generator::generate(options);
+
+        double start = Bench::Runner::now();
+        Breakout::Stage *stage = new Breakout::Stage(window, layout);
+        const double construct = Bench::Runner::now() - start;
+
+        stage->start();
+
+        double update = 0.0, update_max = 0.0, draw = 0.0;
+
+        for (unsigned frame = 0; frame < frames; ++frame) {
+
+            start = Bench::Runner::now();
+            window.update();
+            stage->update();
+            const double updated = Bench::Runner::now();
+
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            window.draw();
+            glFinish();
+
+            update += updated - start;
+            update_max = std::max(update_max, updated - start);
+            draw += Bench::Runner::now() - updated;
+        }
+
+        out << side * side << ',' << construct * 1e3 << ','
+            << update / frames * 1e3 << ',' << update_max * 1e3 << ',' << draw / frames * 1e3 << ','
+            << stage->memory() << ',' << Breakout::Memory::residentBytes() << std::endl;
+
+        // the window deletes the objects on its next update, the arena goes after that
+        stage->clear();
+        window.update();
+        delete stage;
+    }
+}
+
+int main (int argc, char **argv) {
+
+    std::string filter, baseline, save;
+    bool run_sweep = false;
+    std::vector<std::string> stages;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            baseline = argv[++i];
+        } else if (arg == "--save" && i + 1 < argc) {
+            save = argv[++i];
+        } else if (arg == "--sweep") {
+            run_sweep = true;
+        } else {
+            stages.push_back(arg);
+        }
+    }
+
+    if (!glfwInit()) {
+        std::cerr << "ERROR: Could not initialize GLFW" << std::endl;
+        return -1;
+    }
+
+    // meshes draw and stages link their shader, both need a context
+    Engine::Window window(64, 64, "Breakout benchmarks");
+
+    if (!window) {
+        std::cerr << "ERROR: Could not initialize window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+
+    window.makeCurrentContext();
+    glewInit();
+
+    if (run_sweep) {
+        sweep(window, std::cout);
+        Engine::Audio::End();
+        glfwTerminate();
+        return 0;
+    }
+
+    Bench::Runner runner(filter);
+
+    {
+        std::valarray<double> speed = { 0.3, 0.4, 0.0 };
+
+        runner.run("Mesh::norm", [ &speed ] () {
+            Bench::keep(Engine::Mesh::norm(speed));
+        });
+
+        runner.run("Mesh::resize", [ &speed ] () {
+            Bench::keep(Engine::Mesh::resize(speed, 0.5));
+        });
+    }
+
+    runner.run("Color::hex", [] () {
+        Bench::keep(Engine::Color::hex("#3fa7d6"));
+    });
+
+    {
+        Breakout::Events events;
+        Breakout::Arena arena;
+        Breakout::Ball *ball = new Breakout::Ball(events, 1.5, 0.5, { 0.0, 0.0, 4.0 });
+        Breakout::Brick *brick = new (arena) Breakout::Brick(window, events, arena, { 0.0, 0.0, 4.0 }, arena.make<Engine::BackgroundColor>(Engine::Color::hex("#3fa7d6")));
+        const std::valarray<double> point = { 0.0, 0.0, 4.0 }, fast = { 3.0, 0.1, 0.0 }, slow = { 0.1, 0.1, 0.0 };
+        unsigned step = 0;
+
+        // alternates between the clamped and the resized paths
+        runner.run("Ball::setSpeed", [ ball, &step, &fast, &slow ] () {
+            ball->setSpeed((++step & 1) ? fast : slow);
+        });
+
+        runner.run("Brick::onCollision", [ brick, ball, &point, &events ] () {
+            brick->onCollision(ball, point);
+            events.clear();
+        });
+
+        runner.run("Brick::beforeDraw", [ brick ] () {
+            brick->beforeDraw(false);
+        });
+
+        // the engine collision pass only runs inside update, the ball rests on the brick
+        ball->stop();
+        window.addObject(ball);
+        window.addObject(brick);
+
+        runner.run("Window::update ball on brick", [ &window, &events ] () {
+            window.update();
+            events.clear();
+        });
+
+        events.release(ball);
+        events.release(brick);
+        events.collect();
+        window.update();
+    }
+
+    runner.run("Window::setTimeout", [ &window ] () {
+        window.clearTimeout(window.setTimeout([] () { return false; }, 1000.0));
+    });
+
+    Breakout::Jobs::start();
+
+    {
+        Breakout::Jobs::Counter counter;
+
+        // scheduler overhead of one empty task, the bench thread may run it itself
+        runner.run("Jobs::run+wait", [ &counter ] () {
+            Breakout::Jobs::run([] () {}, counter);
+            Breakout::Jobs::wait(counter);
+        });
+
+        std::vector<double> values(4096, 1.0);
+
+        runner.run("Jobs::parallelFor 4096 by 256", [ &values ] () {
+            Breakout::Jobs::parallelFor(0, values.size(), 256, [ &values ] (std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; ++i) {
+                    values[i] = values[i] * 0.5 + 0.5;
+                }
+            });
+            Bench::keep(values);
+        });
+    }
+
+    Breakout::Jobs::stop();
+
+    for (const auto &path : stages) {
+
+        runner.run("Layout::load " + path, [ &path ] () {
+            Breakout::Layout layout;
+            layout.load(path);
+            Bench::keep(layout.rows);
+        });
+
+        Breakout::Layout layout;
+
+        // the build alone, Layout::load above is the parse
+        if (layout.load(path)) {
+            runner.run("Stage::Stage " + path, [ &window, &layout ] () {
+                delete new Breakout::Stage(window, layout);
+            });
+        }
+    }
+
+    if (!save.empty() && !runner.save(save)) {
+        std::cerr << "ERROR: Could not write " << save << std::endl;
+    }
+
+    if (!baseline.empty() && !runner.compare(baseline)) {
+        std::cerr << "ERROR: Could not read " << baseline << std::endl;
+    }
+
+    Engine::Audio::End();
+    glfwTerminate();
+
+    return 0;
+
+}
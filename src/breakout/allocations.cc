@@ -0,0 +1,104 @@
+#include <new>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include "allocations.h"
+#include "profiler.h"
+#include "stats.h"
+
+namespace Breakout {
+
+    constexpr std::size_t Allocations::Zones;
+    Allocations::Zone Allocations::zones[Allocations::Zones];
+    std::atomic<uint64_t> Allocations::total_count(0), Allocations::total_bytes(0);
+    thread_local bool Allocations::forbidden = false;
+
+    void Allocations::record (std::size_t size) {
+
+        static const char *const outside = "(no zone)";
+        const char *name = Profiler::current() ? Profiler::current() : outside;
+
+        if (Allocations::forbidden) {
+            // the message is written without allocating, then the process stops
+            Allocations::forbidden = false;
+            std::fprintf(stderr, "ERROR: %lu byte allocation in %s while allocations are forbidden\n", static_cast<unsigned long>(size), name);
+            std::abort();
+        }
+
+        Allocations::total_count.fetch_add(1, std::memory_order_relaxed);
+        Allocations::total_bytes.fetch_add(size, std::memory_order_relaxed);
+        Stats::add(Stats::Allocations);
+        Stats::add(Stats::AllocatedBytes, size);
+
+        const std::size_t start = (reinterpret_cast<std::size_t>(name) >> 3) % Allocations::Zones;
+
+        for (std::size_t i = 0; i < Allocations::Zones; ++i) {
+
+            Zone &zone = Allocations::zones[(start + i) % Allocations::Zones];
+            const char *current = zone.name.load(std::memory_order_acquire);
+
+            if (!current && zone.name.compare_exchange_strong(current, name, std::memory_order_acq_rel)) {
+                current = name;
+            }
+
+            if (current == name) {
+                zone.count.fetch_add(1, std::memory_order_relaxed);
+                zone.bytes.fetch_add(size, std::memory_order_relaxed);
+                return;
+            }
+        }
+        // table full, the allocation only shows in the totals
+    }
+
+    void Allocations::report (std::ostream &out) {
+
+        struct Line {
+            const char *name;
+            uint64_t count, bytes;
+        };
+
+        std::vector<Line> lines;
+
+        for (const Zone &zone : Allocations::zones) {
+            const char *name = zone.name.load(std::memory_order_acquire);
+            if (name) {
+                lines.push_back({ name, zone.count.load(std::memory_order_relaxed), zone.bytes.load(std::memory_order_relaxed) });
+            }
+        }
+
+        std::sort(lines.begin(), lines.end(), [] (const Line &a, const Line &b) { return a.count > b.count; });
+
+        out << "Allocations: " << Allocations::count() << " (" << Allocations::bytes() << " bytes)" << std::endl;
+
+        for (const Line &line : lines) {
+            out << "  " << line.name << ": " << line.count << " (" << line.bytes << " bytes)" << std::endl;
+        }
+    }
+
+}
+
+#ifdef BREAKOUT_TRACK_ALLOCATIONS
+
+void *operator new (std::size_t size) {
+    Breakout::Allocations::record(size);
+    if (void *pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new (std::size_t size, const std::nothrow_t &) noexcept {
+    Breakout::Allocations::record(size);
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete (void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete (void *pointer, const std::nothrow_t &) noexcept {
+    std::free(pointer);
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef SRC_BREAKOUT_ALLOCATIONS_H_
+#define SRC_BREAKOUT_ALLOCATIONS_H_
+
+#include <atomic>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+namespace Breakout {
+
+    // Counts every global operator new when built with
+    // -DBREAKOUT_TRACK_ALLOCATIONS, per frame through Stats and per profiler
+    // zone for the report. Without the flag nothing is hooked and every
+    // count stays at zero.
+    class Allocations {
+
+    public:
+
+        static constexpr std::size_t Zones = 256;
+
+        struct Zone {
+            std::atomic<const char *> name;
+            std::atomic<uint64_t> count, bytes;
+        };
+
+    private:
+
+        // open addressing on the name pointer, the hook cannot allocate
+        static Zone zones[Allocations::Zones];
+        static std::atomic<uint64_t> total_count, total_bytes;
+        static thread_local bool forbidden;
+
+    public:
+
+        static inline constexpr bool enabled (void) {
+#ifdef BREAKOUT_TRACK_ALLOCATIONS
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        // called by the hook for every allocation
+        static void record(std::size_t size);
+
+        static inline uint64_t count (void) { return Allocations::total_count.load(std::memory_order_relaxed); }
+        static inline uint64_t bytes (void) { return Allocations::total_bytes.load(std::memory_order_relaxed); }
+
+        // any allocation on this thread while forbidden aborts, naming the zone
+        static inline void forbid (bool value) { Allocations::forbidden = value; }
+        static inline bool isForbidden (void) { return Allocations::forbidden; }
+
+        class Forbid {
+
+            const bool previous;
+
+        public:
+
+            inline Forbid (void) : previous(Allocations::isForbidden()) { Allocations::forbid(true); }
+            inline ~Forbid (void) { Allocations::forbid(this->previous); }
+
+            Forbid(const Forbid &) = delete;
+            Forbid &operator=(const Forbid &) = delete;
+
+        };
+
+        // totals per zone, most allocations first
+        static void report(std::ostream &out);
+
+    };
+
+}
+
+#endif
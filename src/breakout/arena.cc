@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <unordered_set>
+#include "arena.h"
+
+namespace Breakout {
+
+    constexpr std::size_t Arena::DefaultChunkSize;
+
+    void *Arena::reuse (std::size_t size, std::size_t alignment, void (*destroy)(void *)) {
+
+        for (auto &list : this->free_lists) {
+            if (list.size == size && list.alignment == alignment && list.destroy == destroy) {
+                if (list.slots.empty()) {
+                    return nullptr;
+                }
+                void *slot = list.slots.back();
+                list.slots.pop_back();
+                this->allocated += size;
+                return slot;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void Arena::recycle (void *pointer, std::size_t size, std::size_t alignment, void (*destroy)(void *)) {
+
+        this->allocated -= size;
+
+        for (auto &list : this->free_lists) {
+            if (list.size == size && list.alignment == alignment && list.destroy == destroy) {
+                list.slots.push_back(pointer);
+                return;
+            }
+        }
+
+        this->free_lists.push_back({ size, alignment, destroy, { pointer } });
+    }
+
+    void *Arena::allocate (std::size_t size, std::size_t alignment) {
+
+        void *slot = this->reuse(size, alignment, nullptr);
+
+        if (slot) {
+            return slot;
+        }
+
+        if (!this->chunks.empty()) {
+
+            Chunk &chunk = this->chunks.back();
+            const std::size_t start = (chunk.used + alignment - 1) & ~(alignment - 1);
+
+            if (start + size <= chunk.size) {
+                chunk.used = start + size;
+                this->allocated += size;
+                return chunk.data + start;
+            }
+        }
+
+        // oversized requests get a chunk of their own
+        const std::size_t size_chunk = std::max(this->chunk_size, size + alignment);
+        Chunk chunk = { static_cast<char *>(::operator new(size_chunk)), size_chunk, 0 };
+        const std::size_t start = (alignment - (reinterpret_cast<std::size_t>(chunk.data) & (alignment - 1))) & (alignment - 1);
+
+        chunk.used = start + size;
+        this->chunks.push_back(chunk);
+        this->allocated += size;
+
+        return chunk.data + start;
+    }
+
+    void Arena::release (void) {
+
+        // disposed objects were destroyed already
+        std::unordered_set<void *> disposed;
+
+        for (const auto &list : this->free_lists) {
+            if (list.destroy) {
+                disposed.insert(list.slots.begin(), list.slots.end());
+            }
+        }
+
+        for (auto destructor = this->destructors.rbegin(); destructor != this->destructors.rend(); ++destructor) {
+            if (disposed.empty() || !disposed.count(destructor->object)) {
+                destructor->destroy(destructor->object);
+            }
+        }
+
+        for (auto &chunk : this->chunks) {
+            ::operator delete(chunk.data);
+        }
+
+        this->destructors.clear();
+        this->free_lists.clear();
+        this->chunks.clear();
+        this->allocated = 0;
+    }
+
+    std::size_t Arena::capacity (void) const {
+        std::size_t total = 0;
+        for (const auto &chunk : this->chunks) {
+            total += chunk.size;
+        }
+        return total;
+    }
+
+}
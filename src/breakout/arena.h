@@ -0,0 +1,101 @@
+#ifndef SRC_BREAKOUT_ARENA_H_
+#define SRC_BREAKOUT_ARENA_H_
+
+#include <new>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+namespace Breakout {
+
+    // Bump allocator for memory that lives exactly as long as its owner.
+    // release drops every chunk at once and runs the destructors registered
+    // by make in reverse order. A slot given back by recycle or dispose is
+    // handed out again to a request of the same size, alignment and type.
+    class Arena {
+
+        struct Chunk {
+            char *data;
+            std::size_t size, used;
+        };
+
+        struct Destructor {
+            void (*destroy)(void *);
+            void *object;
+        };
+
+        // a disposed object keeps its destructor entry, the next object of
+        // the same type in the slot reuses it and release skips free slots
+        struct FreeList {
+            std::size_t size, alignment;
+            void (*destroy)(void *);
+            std::vector<void *> slots;
+        };
+
+        std::vector<Chunk> chunks;
+        std::vector<Destructor> destructors;
+        // a few distinct shapes per arena, searched in order
+        std::vector<FreeList> free_lists;
+        const std::size_t chunk_size;
+        std::size_t allocated = 0;
+
+        template <typename T>
+        static void destroyObject (void *pointer) { static_cast<T *>(pointer)->~T(); }
+
+        template <typename T>
+        static inline void (*destructorOf (void))(void *) {
+            return std::is_trivially_destructible<T>::value ? nullptr : &Arena::destroyObject<T>;
+        }
+
+        void *reuse(std::size_t size, std::size_t alignment, void (*destroy)(void *));
+
+    public:
+
+        static constexpr std::size_t DefaultChunkSize = 64 * 1024;
+
+        inline explicit Arena (std::size_t _chunk_size = Arena::DefaultChunkSize) : chunk_size(_chunk_size) {}
+
+        inline ~Arena (void) { this->release(); }
+
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        void *allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+        template <typename T, typename... Args>
+        inline T *make (Args &&... args) {
+            void (*destroy)(void *) = Arena::destructorOf<T>();
+            void *slot = this->reuse(sizeof(T), alignof(T), destroy);
+            if (slot) {
+                // the destructor registered for the slot's first object covers this one
+                return new (slot) T(std::forward<Args>(args)...);
+            }
+            T *object = new (this->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            if (destroy) {
+                this->destructors.push_back({ destroy, object });
+            }
+            return object;
+        }
+
+        // gives back memory from allocate whose object is already gone
+        void recycle(void *pointer, std::size_t size, std::size_t alignment = alignof(std::max_align_t), void (*destroy)(void *) = nullptr);
+
+        // destroys an object from make now and gives back its slot
+        template <typename T>
+        inline void dispose (T *object) {
+            object->~T();
+            this->recycle(object, sizeof(T), alignof(T), Arena::destructorOf<T>());
+        }
+
+        void release(void);
+
+        // bytes handed out and bytes reserved from the heap
+        inline std::size_t used (void) const { return this->allocated; }
+        std::size_t capacity(void) const;
+
+    };
+
+}
+
+#endif
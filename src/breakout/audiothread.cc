@@ -0,0 +1,133 @@
+#include <algorithm>
+#include "audiothread.h"
+#include "profiler.h"
+
+namespace Breakout {
+
+    constexpr int AudioThread::MaxLatency;
+    std::vector<AudioThread::Fade> AudioThread::fades;
+    Ring<AudioThread::Command, 256> AudioThread::commands;
+    std::thread AudioThread::thread;
+    std::atomic<bool> AudioThread::running(false);
+    std::atomic<unsigned long> AudioThread::dropped(0);
+    std::mutex AudioThread::wake_mutex;
+    std::condition_variable AudioThread::wake;
+
+    void AudioThread::execute (Command &command) {
+
+        Engine::Audio::Sound *sound = command.sound;
+
+        switch (command.operation) {
+            case Operation::OperationPlay:
+                sound->play();
+            break;
+            case Operation::OperationStart:
+                sound->start(command.value);
+            break;
+            case Operation::OperationPause:
+                sound->pause();
+            break;
+            case Operation::OperationSetVolume:
+                sound->setVolume(command.value);
+            break;
+            case Operation::OperationMute:
+                sound->mute();
+            break;
+            case Operation::OperationMaxVolume:
+                sound->maxVolume();
+            break;
+            case Operation::OperationFadeOut:
+                sound->fadeOut(command.value);
+            break;
+            case Operation::OperationFadeIn:
+                if (!AudioThread::isRunning()) {
+                    sound->setVolume(command.value);
+                    break;
+                }
+                // replaces any ramp still running on the same sound
+                AudioThread::fades.erase(std::remove_if(AudioThread::fades.begin(), AudioThread::fades.end(), [ sound ] (const Fade &fade) {
+                    return fade.sound == sound;
+                }), AudioThread::fades.end());
+                sound->setVolume(0);
+                AudioThread::fades.push_back({ sound, command.keep, 0, command.value, command.duration, std::chrono::steady_clock::now() });
+            break;
+            default: break;
+        }
+
+        command.keep.reset();
+    }
+
+    void AudioThread::stepFades (void) {
+
+        const auto now = std::chrono::steady_clock::now();
+
+        AudioThread::fades.erase(std::remove_if(AudioThread::fades.begin(), AudioThread::fades.end(), [ now ] (const Fade &fade) {
+            const double
+                elapsed = std::chrono::duration<double, std::milli>(now - fade.start).count(),
+                progress = fade.duration > 0 ? std::min(elapsed / fade.duration, 1.0) : 1.0;
+            fade.sound->setVolume(fade.from + static_cast<int>((fade.to - fade.from) * progress));
+            return progress >= 1.0;
+        }), AudioThread::fades.end());
+    }
+
+    void AudioThread::loop (void) {
+
+        Command command;
+
+        BREAKOUT_THREAD("audio");
+
+        while (AudioThread::running.load(std::memory_order_acquire)) {
+
+            {
+                BREAKOUT_ZONE("audio commands");
+
+                while (AudioThread::commands.pop(command)) {
+                    AudioThread::execute(command);
+                }
+
+                AudioThread::stepFades();
+            }
+
+            std::unique_lock<std::mutex> lock(AudioThread::wake_mutex);
+            if (AudioThread::commands.empty()) {
+                AudioThread::wake.wait_for(lock, std::chrono::milliseconds(AudioThread::MaxLatency));
+            }
+        }
+    }
+
+    void AudioThread::start (void) {
+        if (!AudioThread::isRunning()) {
+            AudioThread::running.store(true, std::memory_order_release);
+            AudioThread::thread = std::thread(AudioThread::loop);
+        }
+    }
+
+    void AudioThread::stop (void) {
+
+        Command command;
+
+        if (AudioThread::isRunning()) {
+            AudioThread::running.store(false, std::memory_order_release);
+            AudioThread::wake.notify_one();
+            AudioThread::thread.join();
+        }
+
+        while (AudioThread::commands.pop(command)) {
+            AudioThread::execute(command);
+        }
+
+        AudioThread::fades.clear();
+    }
+
+    void AudioThread::post (Command &&command) {
+        if (!AudioThread::isRunning()) {
+            AudioThread::execute(command);
+        } else if (AudioThread::commands.push(std::move(command))) {
+            // never waits, a missed wake up only costs MaxLatency
+            AudioThread::wake.notify_one();
+        } else {
+            AudioThread::dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+}
@@ -0,0 +1,89 @@
+#ifndef SRC_BREAKOUT_AUDIOTHREAD_H_
+#define SRC_BREAKOUT_AUDIOTHREAD_H_
+
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "ring.h"
+#include "../engine/audio.h"
+
+namespace Breakout {
+
+    // Every Engine::Audio call of the game goes through here. The game thread
+    // only pushes into a lock-free queue, the calls themselves run on a
+    // dedicated thread so a busy mixer or device never stalls a frame.
+    class AudioThread {
+
+    public:
+
+        enum Operation : int {
+            OperationPlay = 0,
+            OperationStart = 1,
+            OperationPause = 2,
+            OperationSetVolume = 3,
+            OperationMute = 4,
+            OperationMaxVolume = 5,
+            OperationFadeOut = 6,
+            OperationFadeIn = 7
+        };
+
+        struct Command {
+            Operation operation;
+            Engine::Audio::Sound *sound;
+            // keeps sounds owned by short lived objects alive until executed
+            std::shared_ptr<Engine::Audio::Sound> keep;
+            int value, duration;
+        };
+
+        // worst case latency of a command posted without a wake up
+        static constexpr int MaxLatency = 2;
+
+    private:
+
+        // volume ramps owned by the audio thread
+        struct Fade {
+            Engine::Audio::Sound *sound;
+            std::shared_ptr<Engine::Audio::Sound> keep;
+            int from, to, duration;
+            std::chrono::steady_clock::time_point start;
+        };
+
+        static std::vector<Fade> fades;
+        static Ring<Command, 256> commands;
+        static std::thread thread;
+        static std::atomic<bool> running;
+        static std::atomic<unsigned long> dropped;
+        static std::mutex wake_mutex;
+        static std::condition_variable wake;
+
+        static void execute(Command &command);
+        static void stepFades(void);
+        static void loop(void);
+
+    public:
+
+        static void start(void);
+        static void stop(void);
+
+        static void post(Command &&command);
+
+        static inline void post (Operation operation, Engine::Audio::Sound &sound, int value = 0, int duration = 0) {
+            AudioThread::post({ operation, &sound, nullptr, value, duration });
+        }
+
+        static inline void post (Operation operation, const std::shared_ptr<Engine::Audio::Sound> &sound, int value = 0, int duration = 0) {
+            AudioThread::post({ operation, sound.get(), sound, value, duration });
+        }
+
+        static inline bool isRunning (void) { return AudioThread::running.load(std::memory_order_acquire); }
+        static inline unsigned long droppedCommands (void) { return AudioThread::dropped.load(std::memory_order_relaxed); }
+
+    };
+
+}
+
+#endif
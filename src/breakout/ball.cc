@@ -1,12 +1,31 @@
 #include "ball.h"
+#include "log.h"
 
 namespace Breakout {
 
+    Effect
+        Ball::sound_pop(Voices::PriorityEffect, 0.2, 0.04),
+        Ball::sound_brick(Voices::PriorityEffect, 0.3, 0.04);
+
     void Ball::onCollision (const Object *other, const std::valarray<double> &point) {
 
-        bool is_brick = other->getType() == "breakout_brick", is_paddler = other->getType() == "breakout_paddler";
+        const std::string type = other->getType();
+
+        if (type == "breakout_brick") {
+            if (static_cast<const Brick *>(other)->brickType() != "abstract_brick") {
+                this->events.contact(this, static_cast<const Brick *>(other), other, point);
+            }
+        } else if (type == "breakout_paddler") {
+            this->events.contact(this, static_cast<const Paddler *>(other), other, point);
+        }
+    }
+
+    void Ball::onContact (const Object *other, const std::valarray<double> &point) {
+
+        const std::string type = other->getType();
+        const bool is_brick = type == "breakout_brick", is_paddler = type == "breakout_paddler";
 
-        if ((is_brick && static_cast<const Brick *>(other)->brickType() != "abstract_brick") || is_paddler) {
+        if (is_brick || is_paddler) {
 
             std::valarray<double>
                 speed = this->getSpeed(),
@@ -28,7 +47,7 @@ namespace Breakout {
             }
 
             if (is_brick) {
-                this->sound_brick.play();
+                Ball::sound_brick.play();
                 // deacelerate
                 this->setSpeed(speed * 0.9);
             } else {
@@ -38,9 +57,9 @@ namespace Breakout {
                     proportion = std::max((std::abs(((offset_x + offset_x) / width) - 1.0) * 1.2), 0.8),
                     mouse_y = std::max(std::min(Engine::Event::MouseMove::getMousePosY() + 2.0, 3.0), 1.0) * 0.5;
 
-                std::cout << proportion << std::endl;
+                BREAKOUT_LOG(Debug, Physics, "paddler hit, speed proportion {}", proportion);
 
-                this->sound_pop.play();
+                Ball::sound_pop.play();
                 // add paddler speed
                 this->setSpeed((speed + (other->getSpeed() * 0.8)) * proportion * mouse_y);
             }
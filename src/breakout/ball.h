@@ -8,23 +8,23 @@
 #include <cmath>
 #include "brick.h"
 #include "paddler.h"
+#include "events.h"
+#include "voices.h"
 #include "../engine/event.h"
 #include "../engine/object.h"
 #include "../engine/audio.h"
 
 namespace Breakout {
 
-    class Ball : public Engine::Object {
+    class Ball : public Engine::Object, public Collidable {
 
+        Events &events;
         const std::valarray<double> start_position;
         std::unique_ptr<Engine::Sphere2D> sphere_mesh, sphere_collider;
         std::unique_ptr<Engine::BackgroundColor> background_color;
         double max_speed, min_speed;
-        Engine::Audio::Sound
-            sound_pop = Engine::Audio::Sound("audio/effects/ball_pop.ogg"),
-            sound_brick = Engine::Audio::Sound("audio/effects/ball_brick.ogg");
 
-        std::function<void(void)> touch_bottom;
+        static Effect sound_pop, sound_brick;
 
     public:
 
@@ -33,9 +33,9 @@ namespace Breakout {
         }
 
         Ball (
+            Events &_events,
             double _max_speed,
             double _min_speed,
-            std::function<void(void)> _touch_bottom,
             const std::valarray<double> &_position = { 0.0, 0.0, 0.0 }
         ) : Engine::Object(
             _position,
@@ -43,11 +43,16 @@ namespace Breakout {
             new Engine::Sphere2D({ 0.0, 0.0, 0.0 }, Ball::DefaultRadius()),
             new Engine::Sphere2D({ 0.0, 0.0, 0.0 }, Ball::DefaultRadius()),
             new Engine::BackgroundColor(Engine::Color::rgba(255, 255, 255, 0.5))
-        ), start_position(_position), max_speed(_max_speed), min_speed(_min_speed), touch_bottom(_touch_bottom) {
+        ), Collidable(_events), events(_events), start_position(_position), max_speed(_max_speed), min_speed(_min_speed) {
 
             this->sphere_mesh.reset(static_cast<Engine::Sphere2D *>(this->getMesh()));
             this->sphere_collider.reset(static_cast<Engine::Sphere2D *>(this->getCollider()));
             this->background_color.reset(static_cast<Engine::BackgroundColor *>(this->getBackground()));
+
+            if (!Ball::sound_pop.isLoaded()) {
+                Ball::sound_pop.load("audio/effects/ball_pop.ogg");
+                Ball::sound_brick.load("audio/effects/ball_brick.ogg");
+            }
         }
 
         inline void start (void) {
@@ -65,7 +70,7 @@ namespace Breakout {
 
             if ((position[1] - radius) <= -1.0) {
                 this->stop();
-                this->touch_bottom();
+                this->events.report(Events::ReportTouchBottom, this);
             } else {
                 if ((position[1] + radius) >= 1.0) {
                     speed[1] = -std::abs(speed[1]);
@@ -78,7 +83,7 @@ namespace Breakout {
                 }
 
                 if ((this->getSpeed() != speed).max()) {
-                    this->sound_pop.play();
+                    Ball::sound_pop.play();
                     this->setSpeed(speed);
                 }
             }
@@ -93,7 +98,10 @@ namespace Breakout {
             return this->sphere_mesh->getRadius();
         }
 
+        inline void onRelease (void) { this->destroy(); }
+
         void onCollision(const Object *other, const std::valarray<double> &point);
+        void onContact(const Object *other, const std::valarray<double> &point);
 
         void stop (void) {
             this->setSpeed({ 0.0, 0.0, 0.0 });
@@ -1 +1,12 @@
 #include "brick.h"
+#include "ball.h"
+
+namespace Breakout {
+
+    void Brick::onCollision (const Object *other, const std::valarray<double> &point) {
+        if (other->getType() == "breakout_ball" && this->lives > 0) {
+            this->events.contact(this, static_cast<const Ball *>(other), other, point);
+        }
+    }
+
+}
@@ -6,30 +6,41 @@
 #include <valarray>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "events.h"
+#include "arena.h"
+#include "culling.h"
 #include "../engine/mesh.h"
 #include "../engine/object.h"
 #include "../engine/window.h"
 
 namespace Breakout {
 
-    class Brick : public Engine::Object {
+    class Brick : public Engine::Object, public Collidable {
 
         Engine::Window &window;
+        Events &events;
         double width, height;
         unsigned lives;
         bool draw_border;
-        std::unique_ptr<Engine::Rectangle2D> rect_mesh, rect_collider;
-        std::function<void(Brick *)> on_destroy;
+        // position in the stage list holding the brick and the layout row it came from
+        std::size_t index = 0, row = 0;
 
     public:
 
         static constexpr double DefaultWidth = 0.19, DefaultHeight = 0.05;
 
+        // bricks, their meshes and their colors live in the stage arena, the
+        // window still deletes a brick but the memory goes with the whole stage
+        static inline void *operator new (std::size_t size, Arena &arena) { return arena.allocate(size); }
+        static inline void operator delete (void *pointer, Arena &arena) {}
+        static inline void operator delete (void *pointer) {}
+
         inline Brick (
             Engine::Window &_window,
+            Events &_events,
+            Arena &_arena,
             const std::valarray<double> &_position,
             Engine::Background *_background,
-            std::function<void(Brick *)> _on_destroy,
             double _width = Brick::DefaultWidth,
             double _height = Brick::DefaultHeight,
             const std::valarray<double> &_speed = {0.0, 0.0, 0.0},
@@ -38,46 +49,63 @@ namespace Breakout {
             bool _draw_border = true
         ) : Engine::Object(
             _position, true,
-            new Engine::Rectangle2D({0.0, 0.0, 0.0}, _width, _height),
-            new Engine::Rectangle2D({0.0, 0.0, 0.0}, _width, _height),
+            _arena.make<Engine::Rectangle2D>(std::valarray<double>({0.0, 0.0, 0.0}), _width, _height),
+            _arena.make<Engine::Rectangle2D>(std::valarray<double>({0.0, 0.0, 0.0}), _width, _height),
             _background, _speed, _acceleration
-        ), window(_window), width(_width), height(_height), lives(_lives), draw_border(_draw_border), on_destroy(_on_destroy) {
-
-            this->rect_mesh.reset(static_cast<Engine::Rectangle2D *>(this->getMesh()));
-            this->rect_collider.reset(static_cast<Engine::Rectangle2D *>(this->getCollider()));
-
-        }
+        ), Collidable(_events), window(_window), events(_events), width(_width), height(_height), lives(_lives), draw_border(_draw_border) {}
 
         std::string getType (void) const { return "breakout_brick"; }
         virtual std::string brickType (void) const { return "brick"; }
+        // bytes taken from the arena, for giving them back
+        virtual std::size_t footprint (void) const { return sizeof(Brick); }
 
         inline double getWidth (void) const { return this->width; }
         inline double getheight (void) const { return this->height; }
 
+        inline std::size_t getIndex (void) const { return this->index; }
+        inline void setIndex (std::size_t _index) { this->index = _index; }
+
+        inline std::size_t getRow (void) const { return this->row; }
+        inline void setRow (std::size_t _row) { this->row = _row; }
+
         inline unsigned getLives (void) const { return this->lives; }
         inline bool isDestructible (void) const { return this->getLives() > 0; }
 
         inline Engine::Window &getWindow (void) const { return this->window; }
+        inline Events &getEvents (void) const { return this->events; }
 
         virtual inline void onChangeLives () {}
 
-        inline void onCollision (const Object *other, const std::valarray<double> &point) {
+        void onCollision(const Object *other, const std::valarray<double> &point);
+
+        // called when the stage dispatches the contacts of the tick
+        inline void onContact (const Object *other, const std::valarray<double> &point) {
 
-            if (other->getType() == "breakout_ball" && this->lives > 0) {
+            if (this->lives > 0) {
 
                 --this->lives;
 
                 if (this->lives == 0) {
-                    this->on_destroy(this);
-                    this->destroy();
+                    this->events.report(Events::ReportDestroyed, this);
+                    this->events.release(this);
                 } else {
                     this->onChangeLives();
                 }
             }
         }
 
+        inline void onRelease (void) { this->destroy(); }
+
+        // Window::draw draws every registered mesh itself, only the border
+        // drawn here can be skipped. The mesh starts at the position, so the
+        // box is the brick's own width and height from there.
         inline void beforeDraw (bool only_border) const {
             if (draw_border) {
+                const std::valarray<double> &position = this->getPosition();
+                if (!Culling::visible(position[0], position[1], position[0] + this->width, position[1] + this->height)) {
+                    Culling::culled();
+                    return;
+                }
                 Engine::BackgroundColor bg;
                 if (this->isDestructible()) {
                     bg = Engine::BackgroundColor(Engine::Color::rgba(255, 255, 255, 0.1 * this->getLives()));
@@ -92,33 +120,32 @@ namespace Breakout {
 
     class BonusBrick : public Brick {
 
-        std::function<void(void)> bonus_function;
-
     public:
 
         inline BonusBrick (
             Engine::Window &_window,
+            Events &_events,
+            Arena &_arena,
             const std::valarray<double> &_position,
             Engine::Background *_background,
-            std::function<void(void)> _bonus_function,
-            std::function<void(Brick *)> _on_destroy,
             double _width = Brick::DefaultWidth,
             double _height = Brick::DefaultHeight,
             const std::valarray<double> &_speed = {0.0, 0.0, 0.0},
             const std::valarray<double> &_acceleration = {0.0, 0.0, 0.0},
             unsigned _lives = 1
         ) :
-            Brick(_window, _position, _background, _on_destroy, _width, _height, _speed, _acceleration, _lives, true),
-            bonus_function(_bonus_function) {}
+            Brick(_window, _events, _arena, _position, _background, _width, _height, _speed, _acceleration, _lives, true) {}
 
-        inline void onCollision (const Object *other, const std::valarray<double> &point) {
-            Brick::onCollision(other, point);
-            if (this->getLives() == 0) {
-                this->bonus_function();
+        inline void onContact (const Object *other, const std::valarray<double> &point) {
+            const unsigned lives = this->getLives();
+            Brick::onContact(other, point);
+            if (lives > 0 && this->getLives() == 0) {
+                this->getEvents().report(Events::ReportBonus, this);
             }
         }
 
         std::string brickType (void) const { return "bonus_brick"; }
+        std::size_t footprint (void) const { return sizeof(BonusBrick); }
 
     };
 
@@ -130,15 +157,16 @@ namespace Breakout {
 
         inline AbstractBrick (
             Engine::Window &_window,
+            Events &_events,
+            Arena &_arena,
             const std::valarray<double> &_position,
             Engine::BackgroundColor *_background,
-            std::function<void(Brick *)> _on_destroy,
             double _width = Brick::DefaultWidth,
             double _height = Brick::DefaultHeight,
             const std::valarray<double> &_speed = {0.0, 0.0, 0.0},
             const std::valarray<double> &_acceleration = {0.0, 0.0, 0.0},
             unsigned _lives = 1
-        ) : Brick(_window, _position, _background, _on_destroy, _width, _height, _speed, _acceleration, _lives, false), color(_background) {
+        ) : Brick(_window, _events, _arena, _position, _background, _width, _height, _speed, _acceleration, _lives, false), color(_background) {
             if (this->isDestructible()) {
                 this->color->setA(0.25);
             } else {
@@ -147,6 +175,7 @@ namespace Breakout {
         }
 
         std::string brickType (void) const { return "abstract_brick"; }
+        std::size_t footprint (void) const { return sizeof(AbstractBrick); }
 
     };
 
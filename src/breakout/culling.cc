@@ -0,0 +1,26 @@
+#include <algorithm>
+#include "culling.h"
+#include "stage.h"
+
+namespace Breakout {
+
+    constexpr double Culling::Extent, Culling::RotatedExtent;
+
+    bool Culling::visible (double left, double bottom, double right, double top) {
+
+        if (Stage::waveValue() != 0.0) {
+            return true;
+        }
+
+        if (Stage::rotateValue() != 0.0) {
+            // distance from the centre to the nearest point of the box
+            const double
+                x = std::max(std::max(left, -right), 0.0),
+                y = std::max(std::max(bottom, -top), 0.0);
+            return x * x + y * y <= Culling::RotatedExtent * Culling::RotatedExtent;
+        }
+
+        return right >= -Culling::Extent && left <= Culling::Extent && top >= -Culling::Extent && bottom <= Culling::Extent;
+    }
+
+}
@@ -0,0 +1,29 @@
+#ifndef SRC_BREAKOUT_CULLING_H_
+#define SRC_BREAKOUT_CULLING_H_
+
+#include "stats.h"
+
+namespace Breakout {
+
+    // Whether a box can reach the screen in the frame being drawn. Objects
+    // are placed straight in clip space, so the view is [-1, 1] on both
+    // axes. The rotate bonus turns the scene about the centre, any angle
+    // keeps it inside the circle through the corners. The wave bonus bends
+    // the vertices by an amount only the shader knows, nothing is culled
+    // while it runs.
+    class Culling {
+
+    public:
+
+        static constexpr double Extent = 1.0, RotatedExtent = 1.4142135623730951;
+
+        static bool visible(double left, double bottom, double right, double top);
+
+        // brick borders the caller skipped, reported per frame through Stats::CulledBorders
+        static inline void culled (void) { Stats::add(Stats::CulledBorders); }
+
+    };
+
+}
+
+#endif
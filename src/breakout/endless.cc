@@ -0,0 +1,58 @@
+#include <algorithm>
+#include "endless.h"
+#include "profiler.h"
+
+namespace Breakout {
+
+    static const char *const themes[] = {
+        "siga_em_frente.ogg", "looney_tunes.ogg", "super_mario_bross.ogg", "porque_homem_nao_chora.ogg",
+        "du_hast.ogg", "comboio_do_terror.ogg", "nao_chores_por_mim_argentina.ogg"
+    };
+
+    Generator::Options Endless::difficulty (unsigned long seed, unsigned stage) {
+
+        Generator::Options options;
+
+        // more and tougher bricks and a faster ball, flat after stage 20
+        const double level = std::min(stage, 20u);
+
+        options.rows = 6 + level * 0.6;
+        options.columns = 8 + level * 0.4;
+        options.palette = 3 + stage % 4;
+        options.max_lives = 1 + stage / 4;
+        options.indestructible = level * 0.01;
+        options.max_speed = 1.0 + level * 0.05;
+        options.min_speed = 0.4 + level * 0.03;
+        options.music = themes[stage % (sizeof(themes) / sizeof(themes[0]))];
+        options.seed = seed * 1000003ul + stage;
+
+        return options;
+    }
+
+    Endless::Endless (unsigned long _seed) : seed(_seed) {
+        this->request();
+    }
+
+    void Endless::request (void) {
+
+        const Generator::Options options = Endless::difficulty(this->seed, this->next++);
+
+        Jobs::background([ this, options ] () {
+            BREAKOUT_ZONE("generate stage");
+            this->generated = Generator::generate(options);
+        }, this->generating);
+    }
+
+    bool Endless::take (Layout &layout) {
+
+        if (!this->ready()) {
+            return false;
+        }
+
+        layout = std::move(this->generated);
+        this->request();
+
+        return true;
+    }
+
+}
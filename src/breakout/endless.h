@@ -0,0 +1,50 @@
+#ifndef SRC_BREAKOUT_ENDLESS_H_
+#define SRC_BREAKOUT_ENDLESS_H_
+
+#include "layout.h"
+#include "generator.h"
+#include "jobs.h"
+
+namespace Breakout {
+
+    // Source of generated stages for endless mode. The layout of the next
+    // stage is always being generated on the job workers while the current
+    // one is played, Game builds it in idle time and decodes its track
+    // through Stage::prepare.
+    class Endless {
+
+        const unsigned long seed;
+        unsigned next = 0;
+        // written by the job, read once generating is done
+        Layout generated;
+        Jobs::Counter generating;
+
+        void request(void);
+
+    public:
+
+        // stage n of the difficulty curve, the same seed always gives the same stages
+        static Generator::Options difficulty(unsigned long seed, unsigned stage);
+
+        Endless(unsigned long _seed);
+
+        // the job writes into this object
+        inline ~Endless (void) { Jobs::wait(this->generating); }
+
+        Endless(const Endless &) = delete;
+        Endless &operator=(const Endless &) = delete;
+
+        inline bool ready (void) const { return this->generating.done(); }
+
+        // only before the first frame, when there is nothing else to show
+        inline void wait (void) { Jobs::wait(this->generating); }
+
+        // never waits, false while the layout is still being generated,
+        // otherwise moves it out and starts on the one after
+        bool take(Layout &layout);
+
+    };
+
+}
+
+#endif
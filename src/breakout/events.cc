@@ -0,0 +1,50 @@
+#include <algorithm>
+#include "events.h"
+
+namespace Breakout {
+
+    Collidable::Collidable (Events &events) : serial(events.nextSerial()), handle(events.add(this)) {}
+
+    void Events::dispatch (void) {
+
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->dispatching.swap(this->contacts);
+        }
+
+        // detection order depends on how the engine walks its objects, sort so
+        // the same contacts always produce the same result
+        std::sort(this->dispatching.begin(), this->dispatching.end(), [] (const Contact &a, const Contact &b) {
+            if (a.target_serial != b.target_serial) {
+                return a.target_serial < b.target_serial;
+            }
+            return a.other_serial < b.other_serial;
+        });
+
+        this->last_contacts = this->dispatching.size();
+        this->last_hits = 0;
+
+        for (const auto &contact : this->dispatching) {
+            Collidable *target = this->objects.get(contact.target);
+            if (target && this->objects.get(contact.other_handle)) {
+                target->onContact(contact.other, contact.point);
+                ++this->last_hits;
+            }
+        }
+
+        this->dispatching.clear();
+    }
+
+    void Events::collect (void) {
+
+        for (const Handle &handle : this->releasing) {
+            Collidable *object = this->objects.remove(handle);
+            if (object) {
+                object->onRelease();
+            }
+        }
+
+        this->releasing.clear();
+    }
+
+};
@@ -0,0 +1,142 @@
+#ifndef SRC_BREAKOUT_EVENTS_H_
+#define SRC_BREAKOUT_EVENTS_H_
+
+#include <vector>
+#include <valarray>
+#include <mutex>
+#include "slots.h"
+#include "../engine/object.h"
+
+namespace Breakout {
+
+    class Events;
+
+    // Anything that can receive a deferred contact. The serial comes from the
+    // owning Events so the dispatch order only depends on construction order,
+    // the handle is how contacts and the stage refer to the object.
+    class Collidable {
+
+        const unsigned long serial;
+        const Handle handle;
+
+    public:
+
+        Collidable(Events &events);
+
+        virtual inline ~Collidable (void) {}
+
+        inline unsigned long getSerial (void) const { return this->serial; }
+        inline const Handle &getHandle (void) const { return this->handle; }
+
+        virtual inline void onContact (const Engine::Object *other, const std::valarray<double> &point) {}
+
+        // the batch at the end of the tick decided the object goes away
+        virtual inline void onRelease (void) {}
+
+    };
+
+    // Per tick contact queue. Objects only record contacts while the engine
+    // runs its collision pass, the stage dispatches them once detection is over.
+    // Objects are released in one batch after dispatch, so a contact or a
+    // handle kept past that point resolves to nothing instead of a dangling pointer.
+    class Events {
+
+    public:
+
+        // what an object tells its stage, handled once the contacts of the tick are dispatched
+        enum Report : int {
+            ReportDestroyed = 0,
+            ReportBonus = 1,
+            ReportTouchBottom = 2
+        };
+
+    private:
+
+        struct Notice {
+            Report report;
+            Handle source;
+        };
+
+        struct Contact {
+            Handle target, other_handle;
+            const Engine::Object *other;
+            unsigned long target_serial, other_serial;
+            std::valarray<double> point;
+        };
+
+        std::mutex mutex;
+        std::vector<Contact> contacts, dispatching;
+        std::vector<Notice> notices, notifying;
+        std::vector<Handle> releasing;
+        Slots<Collidable> objects;
+        unsigned long serials = 0;
+        std::size_t last_contacts = 0, last_hits = 0;
+
+    public:
+
+        inline unsigned long nextSerial (void) { return this->serials++; }
+        inline Handle add (Collidable *object) { return this->objects.insert(object); }
+
+        inline Collidable *get (const Handle &handle) const { return this->objects.get(handle); }
+        inline std::size_t size (void) const { return this->objects.size(); }
+
+        // contacts queued in the last dispatched tick and how many reached a live target
+        inline std::size_t contactCount (void) const { return this->last_contacts; }
+        inline std::size_t hitCount (void) const { return this->last_hits; }
+
+        inline void release (const Collidable *object) { this->releasing.push_back(object->getHandle()); }
+
+        inline void contact (
+            Collidable *target,
+            const Collidable *other_collidable,
+            const Engine::Object *other,
+            const std::valarray<double> &point
+        ) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->contacts.push_back({ target->getHandle(), other_collidable->getHandle(), other, target->getSerial(), other_collidable->getSerial(), point });
+        }
+
+        inline void report (Report report, const Collidable *source) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->notices.push_back({ report, source->getHandle() });
+        }
+
+        // handler is called as handler(report, source), sources released in
+        // the meantime are skipped
+        template <typename F>
+        inline void notify (F handler) {
+
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->notifying.swap(this->notices);
+            }
+
+            for (const auto &notice : this->notifying) {
+                Collidable *source = this->objects.get(notice.source);
+                if (source) {
+                    handler(notice.report, source);
+                }
+            }
+
+            this->notifying.clear();
+        }
+
+        inline bool empty (void) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            return this->contacts.empty();
+        }
+
+        inline void clear (void) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->contacts.clear();
+            this->notices.clear();
+        }
+
+        void dispatch(void);
+        void collect(void);
+
+    };
+
+}
+
+#endif
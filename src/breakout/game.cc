@@ -2,23 +2,94 @@
 
 namespace Breakout {
 
-    Game::Game (Engine::Window &_window, std::vector<std::string> _stages)
-    : window(_window) {
-        for (const auto &stage : _stages) {
-            this->stages.push(new Stage(this->window, stage));
+    Game::Game (Engine::Window &_window, std::vector<std::string> _stages, Endless *_endless)
+    : window(_window), endless(_endless) {
+
+        BREAKOUT_ZONE("load stages");
+
+        this->layouts.resize(_stages.size());
+
+        // files are parsed in parallel, only the first stage is built here
+        Jobs::parallelFor(0, _stages.size(), 1, [ this, &_stages ] (std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                this->layouts[i].load(_stages[i]);
+            }
+        });
+
+        // nothing is on screen yet, the first generated stage is waited for
+        if (this->layouts.empty() && this->endless) {
+            this->endless->wait();
+            this->layouts.emplace_back();
+            this->endless->take(this->layouts.back());
+        }
+
+        if (!this->layouts.empty()) {
+            this->build();
+            this->stages.front()->prepare();
         }
 
+        // the rest is built one stage ahead in the time window.sync would sleep
+        this->schedulePrefetch();
+
         this->sound_win.load("audio/effects/youwin.ogg");
         this->sound_lose.load("audio/effects/youlose.ogg");
 
         this->texture_win = loadPNG("images/youwin.png");
         this->texture_lose = loadPNG("images/youlose.png");
+        this->texture_life = loadPNG("images/life.png");
+
+        for (GLuint texture : { this->texture_win, this->texture_lose, this->texture_life }) {
+            Memory::add(Memory::Textures, Memory::textureBytes(texture));
+        }
+    }
+
+    void Game::render (void) {
+
+        BREAKOUT_ZONE("hud");
+
+        if (!this->stages.empty()) {
+
+            const Stage *stage = this->stages.front();
+            double x = 0.7;
+
+            this->window.drawNumber(stage->destroyedCount(), 0.15, { -1.0, 0.85, 4.0 });
+
+            for (unsigned i = 0; i < stage->livesLeft(); ++i) {
+                this->window.addTexture2D(this->texture_life, 0.1, 0.1, { x, 0.88, 4.0 });
+                x += 0.1;
+            }
+
+        } else if (this->won) {
+            this->window.addTexture2D(this->texture_win, 1.0, 2.0, { -0.5, -1.0, 4.0 });
+        } else if (this->lost) {
+            this->window.addTexture2D(this->texture_lose, 2.0, 1.0, { -1.0, -0.5, 4.0 });
+        }
     }
 
     void Game::clear (void) {
+        delete this->retired;
+        this->retired = nullptr;
+        // the stage in play just gave its objects back to the window, its
+        // arena has to outlive the next window update like a won stage
+        if (!this->stages.empty()) {
+            this->stages.front()->clear();
+            this->retired = this->stages.front();
+            this->stages.pop_front();
+        }
         while (!this->stages.empty()) {
             delete this->stages.front();
-            this->stages.pop();
+            this->stages.pop_front();
         }
+        this->layouts.clear();
+        // a lost game ends endless mode too, waits for the layout being generated
+        delete this->endless;
+        this->endless = nullptr;
+    }
+
+    Game::~Game (void) {
+        Idle::cancel(this->prefetch_task);
+        this->clear();
+        delete this->retired;
+        Voices::clear();
     }
 };
@@ -1,8 +1,16 @@
 #ifndef SRC_BREAKOUT_GAME_H_
 #define SRC_BREAKOUT_GAME_H_
 
-#include <queue>
+#include <deque>
 #include "stage.h"
+#include "voices.h"
+#include "layout.h"
+#include "jobs.h"
+#include "profiler.h"
+#include "stats.h"
+#include "memory.h"
+#include "idle.h"
+#include "endless.h"
 #include "../engine/window.h"
 
 namespace Breakout {
@@ -10,12 +18,118 @@ namespace Breakout {
     class Game {
 
         Engine::Window &window;
-        std::queue<Stage *> stages;
+        std::deque<Stage *> stages;
+        // parsed but not built yet, they follow the stages in play order
+        std::deque<Layout> layouts;
+        // endless mode, generates the layouts after the ones from argv
+        Endless *endless;
+        unsigned long prefetch_task = 0;
+        // a won stage is only deleted on the next tick, after the engine let go of its objects
+        Stage *retired = nullptr;
         bool won = false, lost = false;
-        Engine::Audio::Sound sound_win, sound_lose;
-        GLuint texture_win, texture_lose;
+        Effect sound_win = { Voices::PriorityJingle, 5.0 }, sound_lose = { Voices::PriorityJingle, 5.0 };
+        GLuint texture_win, texture_lose, texture_life;
 
-        inline void nextStage (void) {
+        // the rows are left to Stage::buildStep and Stage::start
+        inline void build (void) {
+            BREAKOUT_ZONE("build stage");
+            this->stages.push_back(new Stage(this->window, this->layouts.front(), true));
+            this->layouts.pop_front();
+        }
+
+        // the stage after the one in play still has to be created or built
+        inline bool prefetchPending (void) const {
+            if (this->stages.size() < 2) {
+                // the generator thread is never waited on, a late layout is taken on a later frame
+                return !this->layouts.empty() || (this->endless && this->endless->ready());
+            }
+            return !this->stages[1]->isBuilt();
+        }
+
+        // Idle task, one slice creates the next stage or builds one of its
+        // rows, so the estimate Idle keeps is the cost of one slice. It is
+        // only posted while there is work, a slice that did nothing would
+        // lower the estimate.
+        inline bool prefetch (void) {
+
+            if (this->prefetchPending()) {
+                if (this->stages.size() < 2) {
+                    if (this->layouts.empty()) {
+                        this->layouts.emplace_back();
+                        this->endless->take(this->layouts.back());
+                    }
+                    this->build();
+                } else {
+                    this->stages[1]->buildStep();
+                }
+                // the track decodes on its own while the rows are built
+                if (this->stages.size() == 2) {
+                    this->stages[1]->prepare();
+                }
+            }
+
+            if (!this->prefetchPending()) {
+                this->prefetch_task = 0;
+                return false;
+            }
+
+            return true;
+        }
+
+        inline void schedulePrefetch (void) {
+            if (!this->prefetch_task && this->prefetchPending()) {
+                this->prefetch_task = Idle::post([ this ] () {
+                    return this->prefetch();
+                });
+            }
+        }
+
+        // The frame thread never builds a stage or waits for one: the won
+        // stage stays in front, already cleared, until idle time has built
+        // the next one. False while the game has to stay on this screen.
+        inline bool nextStage (void) {
+
+            if (this->stages.size() > 1) {
+
+                if (!this->stages[1]->isBuilt()) {
+                    return false;
+                }
+
+                this->retired = this->stages.front();
+                this->stages.pop_front();
+                this->stages.front()->start(true);
+
+                // decode the following track while this stage is played
+                if (this->stages.size() > 1) {
+                    this->stages[1]->prepare();
+                }
+
+                return true;
+            }
+
+            // more stages are still to be parsed or generated
+            if (!this->layouts.empty() || this->endless) {
+                return false;
+            }
+
+            this->retired = this->stages.front();
+            this->stages.pop_front();
+            this->sound_win.play();
+            this->won = true;
+
+            return true;
+        }
+
+    public:
+
+        // takes ownership of _endless, its stages are played after _stages
+        Game(Engine::Window &_window, std::vector<std::string> _stages, Endless *_endless = nullptr);
+
+        ~Game(void);
+
+        void clear(void);
+
+        inline void start (void) {
             if (!this->stages.empty()) {
                 this->stages.front()->start();
             } else {
@@ -24,36 +138,42 @@ namespace Breakout {
             }
         }
 
-    public:
+        inline void update (void) {
 
-        Game(Engine::Window &_window, std::vector<std::string> _stages);
+            BREAKOUT_ZONE("game update");
 
-        inline ~Game (void) { this->clear(); }
+            delete this->retired;
+            this->retired = nullptr;
 
-        void clear(void);
+            // also picks up a layout the endless generator finished since the last tick
+            this->schedulePrefetch();
 
-        inline void start (void) { this->nextStage(); }
-
-        inline void update (void) {
             if (!this->stages.empty()) {
                 Stage *stage = this->stages.front();
-                stage->update();
+                // a won stage is already cleared, it only waits for the next one
+                if (!stage->won()) {
+                    stage->update();
+                    Stats::set(Stats::Objects, stage->objects());
+                    Stats::set(Stats::Timers, stage->timers());
+                    Stats::set(Stats::Contacts, stage->contacts());
+                    Stats::set(Stats::Hits, stage->hits());
+                    Stats::set(Stats::Bonuses, stage->bonuses());
+                }
                 if (stage->won()) {
-                    this->stages.pop();
                     this->nextStage();
-                    delete stage;
                 } else if (stage->lost()) {
                     this->sound_lose.play();
                     this->lost = true;
                     this->clear();
                 }
-            } else if (this->won) {
-                this->window.addTexture2D(this->texture_win, 1.0, 2.0, { -0.5, -1.0, 4.0 });
-            } else if (this->lost) {
-                this->window.addTexture2D(this->texture_lose, 2.0, 1.0, { -1.0, -0.5, 4.0 });
             }
+
+            Voices::update();
+            Stats::set(Stats::AudioVoices, Voices::activeVoices());
         }
 
+        void render(void);
+
     };
 
 }
@@ -0,0 +1,66 @@
+#include <cstdio>
+#include <algorithm>
+#include "generator.h"
+
+namespace Breakout {
+
+    constexpr double Generator::Top, Generator::Bottom, Generator::Space, Generator::MinSize, Generator::MaxHeight;
+
+    Layout Generator::generate (const Options &options) {
+
+        Layout layout;
+        std::mt19937 random(options.seed);
+        std::uniform_real_distribution<double> chance(0.0, 1.0);
+        std::uniform_int_distribution<unsigned> channel(40, 255), lives(1, std::min(std::max(options.max_lives, 1u), 3u));
+        std::vector<std::string> palette;
+
+        for (unsigned i = 0; i < std::max(options.palette, 1u); ++i) {
+            char color[8];
+            std::snprintf(color, sizeof(color), "#%02X%02X%02X", channel(random), channel(random), channel(random));
+            palette.push_back(color);
+        }
+
+        std::uniform_int_distribution<std::size_t> pick(0, palette.size() - 1);
+        const double weights = std::max(options.normal + options.bonus + options.abstract, 1e-9);
+
+        layout.max_speed = options.max_speed;
+        layout.min_speed = options.min_speed;
+        layout.width = std::max(2.0 / std::max(options.columns, 1u) - Generator::Space, Generator::MinSize);
+        layout.height = options.tall ? Generator::MaxHeight :
+            std::max(std::min((Generator::Top - Generator::Bottom) / std::max(options.rows, 1u) - Generator::Space, Generator::MaxHeight), Generator::MinSize);
+        layout.ball_x = 0.0;
+        layout.ball_y = -0.5;
+        layout.music = options.music;
+        layout.rows.resize(options.rows);
+
+        // same ids as the hand made stages: 0 indestructible, 1-3 lives,
+        // 4-6 bonus with 1-3 lives, 8 abstract
+        for (auto &row : layout.rows) {
+            row.reserve(options.columns);
+            for (unsigned column = 0; column < options.columns; ++column) {
+
+                unsigned type;
+
+                if (chance(random) < options.indestructible) {
+                    type = 0;
+                } else {
+                    const double kind = chance(random) * weights;
+                    if (kind < options.normal) {
+                        type = lives(random);
+                    } else if (kind < options.normal + options.bonus) {
+                        type = 3 + lives(random);
+                    } else {
+                        type = 8;
+                    }
+                }
+
+                row.push_back(std::to_string(type) + palette[pick(random)]);
+            }
+        }
+
+        layout.loaded = true;
+
+        return layout;
+    }
+
+}
@@ -0,0 +1,39 @@
+#ifndef SRC_BREAKOUT_GENERATOR_H_
+#define SRC_BREAKOUT_GENERATOR_H_
+
+#include <string>
+#include <random>
+#include "layout.h"
+
+namespace Breakout {
+
+    // Builds random stages of any size. The bricks fill the band between the
+    // top of the screen and the middle, so the ball and the paddler stay free,
+    // unless the stage is tall.
+    class Generator {
+
+    public:
+
+        struct Options {
+            unsigned rows = 10, columns = 10, palette = 4;
+            // share of the bricks that cannot be destroyed, the rest is
+            // split between the kinds by these weights
+            double indestructible = 0.1, normal = 0.8, bonus = 0.15, abstract = 0.05;
+            double max_speed = 1.5, min_speed = 0.5;
+            // lives of the normal and bonus bricks are drawn from 1 to this, at most 3
+            unsigned max_lives = 3;
+            std::string music = "siga_em_frente.ogg";
+            unsigned long seed = 0;
+            // rows keep MaxHeight and run past the top of the screen, the stage scrolls
+            bool tall = false;
+        };
+
+        static constexpr double Top = 0.9, Bottom = 0.1, Space = 0.01, MinSize = 0.002, MaxHeight = 0.05;
+
+        static Layout generate(const Options &options);
+
+    };
+
+}
+
+#endif
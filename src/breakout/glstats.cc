@@ -0,0 +1,142 @@
+#include <GL/glew.h>
+#include "glstats.h"
+#include "stats.h"
+
+namespace Breakout {
+
+    std::size_t GLStats::pixelBytes (GLenum format, GLenum type) {
+
+        std::size_t components;
+
+        switch (format) {
+            case GL_RED: case GL_GREEN: case GL_BLUE: case GL_ALPHA: case GL_LUMINANCE: components = 1; break;
+            case GL_LUMINANCE_ALPHA: components = 2; break;
+            case GL_RGB: case GL_BGR: components = 3; break;
+            default: components = 4; break;
+        }
+
+        switch (type) {
+            case GL_UNSIGNED_BYTE: case GL_BYTE: return components;
+            case GL_UNSIGNED_SHORT: case GL_SHORT: return components * 2;
+            case GL_FLOAT: case GL_UNSIGNED_INT: case GL_INT: return components * 4;
+            // packed formats hold the whole pixel in one value
+            default: return 4;
+        }
+    }
+
+}
+
+// Built with -DBREAKOUT_GL_STATS and linked with -Wl,--wrap for every
+// function below (see GL_WRAP in the Makefile), so the engine's calls are
+// counted too. Calls GLEW resolves at runtime do not go through the linker.
+#ifdef BREAKOUT_GL_STATS
+
+using Breakout::Stats;
+
+extern "C" {
+
+    void __real_glBegin(GLenum mode);
+    void __real_glDrawArrays(GLenum mode, GLint first, GLsizei count);
+    void __real_glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices);
+    void __real_glEnable(GLenum cap);
+    void __real_glDisable(GLenum cap);
+    void __real_glBlendFunc(GLenum sfactor, GLenum dfactor);
+    void __real_glDepthFunc(GLenum func);
+    void __real_glAlphaFunc(GLenum func, GLclampf ref);
+    void __real_glShadeModel(GLenum mode);
+    void __real_glMatrixMode(GLenum mode);
+    void __real_glViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+    void __real_glBindTexture(GLenum target, GLuint texture);
+    void __real_glTexImage2D(GLenum target, GLint level, GLint internal, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels);
+    void __real_glTexSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels);
+    void __real_glVertex2d(GLdouble x, GLdouble y);
+    void __real_glVertex3d(GLdouble x, GLdouble y, GLdouble z);
+
+    void __wrap_glBegin (GLenum mode) {
+        Stats::add(Stats::DrawCalls);
+        __real_glBegin(mode);
+    }
+
+    void __wrap_glDrawArrays (GLenum mode, GLint first, GLsizei count) {
+        Stats::add(Stats::DrawCalls);
+        __real_glDrawArrays(mode, first, count);
+    }
+
+    void __wrap_glDrawElements (GLenum mode, GLsizei count, GLenum type, const GLvoid *indices) {
+        Stats::add(Stats::DrawCalls);
+        __real_glDrawElements(mode, count, type, indices);
+    }
+
+    void __wrap_glEnable (GLenum cap) {
+        Stats::add(Stats::StateChanges);
+        __real_glEnable(cap);
+    }
+
+    void __wrap_glDisable (GLenum cap) {
+        Stats::add(Stats::StateChanges);
+        __real_glDisable(cap);
+    }
+
+    void __wrap_glBlendFunc (GLenum sfactor, GLenum dfactor) {
+        Stats::add(Stats::StateChanges);
+        __real_glBlendFunc(sfactor, dfactor);
+    }
+
+    void __wrap_glDepthFunc (GLenum func) {
+        Stats::add(Stats::StateChanges);
+        __real_glDepthFunc(func);
+    }
+
+    void __wrap_glAlphaFunc (GLenum func, GLclampf ref) {
+        Stats::add(Stats::StateChanges);
+        __real_glAlphaFunc(func, ref);
+    }
+
+    void __wrap_glShadeModel (GLenum mode) {
+        Stats::add(Stats::StateChanges);
+        __real_glShadeModel(mode);
+    }
+
+    void __wrap_glMatrixMode (GLenum mode) {
+        Stats::add(Stats::StateChanges);
+        __real_glMatrixMode(mode);
+    }
+
+    void __wrap_glViewport (GLint x, GLint y, GLsizei width, GLsizei height) {
+        Stats::add(Stats::StateChanges);
+        __real_glViewport(x, y, width, height);
+    }
+
+    void __wrap_glBindTexture (GLenum target, GLuint texture) {
+        Stats::add(Stats::TextureBinds);
+        __real_glBindTexture(target, texture);
+    }
+
+    void __wrap_glTexImage2D (GLenum target, GLint level, GLint internal, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels) {
+        Stats::add(Stats::Uploads);
+        if (pixels) {
+            Stats::add(Stats::UploadBytes, static_cast<std::size_t>(width) * height * Breakout::GLStats::pixelBytes(format, type));
+        }
+        __real_glTexImage2D(target, level, internal, width, height, border, format, type, pixels);
+    }
+
+    void __wrap_glTexSubImage2D (GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels) {
+        Stats::add(Stats::Uploads);
+        Stats::add(Stats::UploadBytes, static_cast<std::size_t>(width) * height * Breakout::GLStats::pixelBytes(format, type));
+        __real_glTexSubImage2D(target, level, x, y, width, height, format, type, pixels);
+    }
+
+    // immediate mode sends every vertex to the driver on its own
+    void __wrap_glVertex2d (GLdouble x, GLdouble y) {
+        Stats::add(Stats::UploadBytes, 2 * sizeof(GLdouble));
+        __real_glVertex2d(x, y);
+    }
+
+    void __wrap_glVertex3d (GLdouble x, GLdouble y, GLdouble z) {
+        Stats::add(Stats::UploadBytes, 3 * sizeof(GLdouble));
+        __real_glVertex3d(x, y, z);
+    }
+
+}
+
+#endif
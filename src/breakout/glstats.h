@@ -0,0 +1,30 @@
+#ifndef SRC_BREAKOUT_GLSTATS_H_
+#define SRC_BREAKOUT_GLSTATS_H_
+
+#include <cstddef>
+#include <GL/glew.h>
+
+namespace Breakout {
+
+    // GL calls counted per frame into Stats: draw calls, state changes,
+    // texture binds, uploads and the bytes they moved. Only active in a
+    // build made with GLSTATS=1, otherwise those counters stay at zero.
+    class GLStats {
+
+    public:
+
+        static inline constexpr bool enabled (void) {
+#ifdef BREAKOUT_GL_STATS
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        static std::size_t pixelBytes(GLenum format, GLenum type);
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,58 @@
+#include <algorithm>
+#include "idle.h"
+#include "profiler.h"
+#include "stats.h"
+
+namespace Breakout {
+
+    constexpr uint64_t Idle::Margin, Idle::FirstCost;
+    std::deque<Idle::Entry> Idle::tasks;
+    unsigned long Idle::next_id = 0;
+
+    unsigned long Idle::post (Task task) {
+        Idle::tasks.push_back({ ++Idle::next_id, std::move(task), static_cast<double>(Idle::FirstCost) });
+        return Idle::next_id;
+    }
+
+    void Idle::cancel (unsigned long id) {
+        Idle::tasks.erase(std::remove_if(Idle::tasks.begin(), Idle::tasks.end(), [ id ] (const Entry &entry) {
+            return entry.id == id;
+        }), Idle::tasks.end());
+    }
+
+    void Idle::run (uint64_t deadline) {
+
+        BREAKOUT_ZONE("idle");
+
+        const uint64_t start = Profiler::now();
+        const uint64_t end = deadline > start + Idle::Margin ? deadline - Idle::Margin : start;
+
+        // tasks posted by a slice wait for the next frame
+        for (std::size_t count = Idle::tasks.size(); count; --count) {
+
+            Entry entry = std::move(Idle::tasks.front());
+            Idle::tasks.pop_front();
+
+            const uint64_t begin = Profiler::now();
+
+            if (begin + entry.cost > end) {
+                Idle::tasks.push_back(std::move(entry));
+                continue;
+            }
+
+            const bool more = entry.task();
+
+            // a slow slice raises the estimate at once, a fast one lowers it slowly
+            const double cost = Profiler::now() - begin;
+            entry.cost = std::max(cost, entry.cost * 0.875 + cost * 0.125);
+
+            if (more) {
+                Idle::tasks.push_back(std::move(entry));
+            }
+        }
+
+        Stats::set(Stats::IdleTime, (Profiler::now() - start) / 1000);
+        Stats::set(Stats::IdleBudget, (end - start) / 1000);
+    }
+
+}
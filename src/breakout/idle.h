@@ -0,0 +1,50 @@
+#ifndef SRC_BREAKOUT_IDLE_H_
+#define SRC_BREAKOUT_IDLE_H_
+
+#include <deque>
+#include <functional>
+#include <cstdint>
+
+namespace Breakout {
+
+    // Low priority work for the main thread, run between the end of the
+    // frame's own work and the deadline window.sync would sleep until. Every
+    // task gets at most one slice per frame and only when the slice it took
+    // last time still fits before the deadline.
+    class Idle {
+
+    public:
+
+        // returns true while it has more to do on later frames
+        typedef std::function<bool(void)> Task;
+
+        // nanoseconds, the margin is left for sync to wake up on time
+        static constexpr uint64_t Margin = 1000000, FirstCost = 500000;
+
+    private:
+
+        struct Entry {
+            unsigned long id;
+            Task task;
+            double cost;
+        };
+
+        static std::deque<Entry> tasks;
+        static unsigned long next_id;
+
+    public:
+
+        static unsigned long post(Task task);
+        static void cancel(unsigned long id);
+
+        // deadline in Profiler::now() time, sets Stats::IdleTime and
+        // Stats::IdleBudget to what was used out of what was left
+        static void run(uint64_t deadline);
+
+        static inline std::size_t pending (void) { return Idle::tasks.size(); }
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,288 @@
+#include <chrono>
+#include <algorithm>
+#include "jobs.h"
+#include "profiler.h"
+
+namespace Breakout {
+
+    std::vector<std::unique_ptr<Jobs::Queue>> Jobs::queues;
+    Jobs::Queue Jobs::inbox;
+    std::vector<std::thread> Jobs::workers;
+    std::atomic<bool> Jobs::running(false);
+    std::atomic<unsigned> Jobs::sleeping(0);
+    std::mutex Jobs::sleep_mutex;
+    std::condition_variable Jobs::wake;
+    thread_local unsigned Jobs::worker_index = 0;
+
+    void Jobs::Counter::increment (void) {
+        this->value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Jobs::Counter::decrement (void) {
+
+        std::vector<Task *> released;
+
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (this->value.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                released.swap(this->waiting);
+            }
+        }
+
+        // the counter may be gone by now, only the local list is used
+        for (Task *task : released) {
+            Jobs::push(task);
+        }
+    }
+
+    void Jobs::push (Task *task) {
+
+        Queue &queue = *Jobs::queues[Jobs::worker_index];
+
+        queue.acquire();
+        queue.tasks.push_back(task);
+        queue.release();
+
+        if (Jobs::sleeping.load(std::memory_order_acquire)) {
+            Jobs::wake.notify_one();
+        }
+    }
+
+    Jobs::Task *Jobs::pop (void) {
+
+        Queue &queue = *Jobs::queues[Jobs::worker_index];
+        Task *task = nullptr;
+
+        queue.acquire();
+        if (!queue.tasks.empty()) {
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+        }
+        queue.release();
+
+        return task;
+    }
+
+    Jobs::Task *Jobs::steal (void) {
+
+        const unsigned size = Jobs::queues.size();
+
+        for (unsigned i = 1; i < size; ++i) {
+
+            Queue &queue = *Jobs::queues[(Jobs::worker_index + i) % size];
+            Task *task = nullptr;
+
+            queue.acquire();
+            if (!queue.tasks.empty()) {
+                task = queue.tasks.front();
+                queue.tasks.pop_front();
+            }
+            queue.release();
+
+            if (task) {
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    Jobs::Task *Jobs::receive (void) {
+
+        Task *task = nullptr;
+
+        Jobs::inbox.acquire();
+        if (!Jobs::inbox.tasks.empty()) {
+            task = Jobs::inbox.tasks.front();
+            Jobs::inbox.tasks.pop_front();
+        }
+        Jobs::inbox.release();
+
+        return task;
+    }
+
+    void Jobs::execute (Task *task) {
+
+        {
+            BREAKOUT_ZONE("job");
+            task->work();
+        }
+
+        if (task->done) {
+            task->done->decrement();
+        }
+
+        delete task;
+    }
+
+    void Jobs::loop (unsigned index) {
+
+        Jobs::worker_index = index;
+
+        BREAKOUT_THREAD("worker " + std::to_string(index));
+
+        while (Jobs::running.load(std::memory_order_acquire)) {
+
+            Task *task = Jobs::pop();
+
+            if (!task) {
+                task = Jobs::receive();
+            }
+
+            if (!task) {
+                task = Jobs::steal();
+            }
+
+            if (task) {
+                Jobs::execute(task);
+            } else {
+                std::unique_lock<std::mutex> lock(Jobs::sleep_mutex);
+                Jobs::sleeping.fetch_add(1, std::memory_order_acq_rel);
+                Jobs::wake.wait_for(lock, std::chrono::milliseconds(1));
+                Jobs::sleeping.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        }
+    }
+
+    void Jobs::start (unsigned count) {
+
+        if (Jobs::isRunning()) {
+            return;
+        }
+
+        // the calling thread is worker 0, one more thread always exists for background jobs
+        count = std::max(count, 2u);
+
+        Jobs::worker_index = 0;
+
+        for (unsigned i = 0; i < count; ++i) {
+            Jobs::queues.emplace_back(new Queue);
+        }
+
+        Jobs::running.store(true, std::memory_order_release);
+
+        for (unsigned i = 1; i < count; ++i) {
+            Jobs::workers.emplace_back(Jobs::loop, i);
+        }
+    }
+
+    void Jobs::stop (void) {
+
+        if (!Jobs::isRunning()) {
+            return;
+        }
+
+        Jobs::running.store(false, std::memory_order_release);
+        Jobs::wake.notify_all();
+
+        for (auto &worker : Jobs::workers) {
+            worker.join();
+        }
+
+        Jobs::workers.clear();
+
+        // a finished task can release continuations onto queue 0, so the
+        // queues are popped until a whole pass finds all of them empty
+        for (bool pending = true; pending; ) {
+            pending = false;
+            for (Task *task = Jobs::receive(); task; task = Jobs::receive()) {
+                Jobs::execute(task);
+                pending = true;
+            }
+            for (auto &queue : Jobs::queues) {
+                while (!queue->tasks.empty()) {
+                    Task *task = queue->tasks.front();
+                    queue->tasks.pop_front();
+                    Jobs::execute(task);
+                    pending = true;
+                }
+            }
+        }
+
+        Jobs::queues.clear();
+    }
+
+    void Jobs::run (std::function<void(void)> work, Counter &done) {
+
+        if (!Jobs::isRunning()) {
+            work();
+            return;
+        }
+
+        done.increment();
+        Jobs::push(new Task{ std::move(work), &done });
+    }
+
+    void Jobs::background (std::function<void(void)> work, Counter &done) {
+
+        if (!Jobs::isRunning()) {
+            work();
+            return;
+        }
+
+        done.increment();
+
+        Jobs::inbox.acquire();
+        Jobs::inbox.tasks.push_back(new Task{ std::move(work), &done });
+        Jobs::inbox.release();
+
+        if (Jobs::sleeping.load(std::memory_order_acquire)) {
+            Jobs::wake.notify_one();
+        }
+    }
+
+    void Jobs::run (std::function<void(void)> work, Counter &done, Counter &after) {
+
+        if (!Jobs::isRunning()) {
+            work();
+            return;
+        }
+
+        Task *task = new Task{ std::move(work), &done };
+
+        done.increment();
+
+        {
+            std::lock_guard<std::mutex> lock(after.mutex);
+            if (after.value.load(std::memory_order_acquire) != 0) {
+                after.waiting.push_back(task);
+                return;
+            }
+        }
+
+        Jobs::push(task);
+    }
+
+    void Jobs::wait (Counter &counter) {
+
+        while (!counter.done()) {
+
+            Task *task = Jobs::pop();
+
+            if (!task) {
+                task = Jobs::steal();
+            }
+
+            if (task) {
+                Jobs::execute(task);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void Jobs::parallelFor (std::size_t begin, std::size_t end, std::size_t grain, const std::function<void(std::size_t, std::size_t)> &work) {
+
+        Counter counter;
+
+        grain = std::max(grain, static_cast<std::size_t>(1));
+
+        for (std::size_t first = begin; first < end; first += grain) {
+            const std::size_t last = std::min(first + grain, end);
+            Jobs::run([ &work, first, last ] () { work(first, last); }, counter);
+        }
+
+        Jobs::wait(counter);
+    }
+
+}
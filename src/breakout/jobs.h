@@ -0,0 +1,117 @@
+#ifndef SRC_BREAKOUT_JOBS_H_
+#define SRC_BREAKOUT_JOBS_H_
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace Breakout {
+
+    // Work-stealing scheduler. Every worker owns a deque: it pushes and pops
+    // at the back, idle workers steal from the front of the others. The
+    // thread that called Jobs::start owns deque 0 and works while it waits.
+    // Background jobs go to a shared inbox only the worker threads read, so
+    // a wait on the main thread never picks them up.
+    class Jobs {
+
+    public:
+
+        class Counter;
+
+    private:
+
+        struct Task {
+            std::function<void(void)> work;
+            Counter *done;
+        };
+
+        struct Queue {
+            std::atomic_flag lock = ATOMIC_FLAG_INIT;
+            std::deque<Task *> tasks;
+
+            inline void acquire (void) {
+                for (unsigned spins = 0; this->lock.test_and_set(std::memory_order_acquire); ++spins) {
+                    if (spins > 64) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+            inline void release (void) { this->lock.clear(std::memory_order_release); }
+        };
+
+        static std::vector<std::unique_ptr<Queue>> queues;
+        static Queue inbox;
+        static std::vector<std::thread> workers;
+        static std::atomic<bool> running;
+        static std::atomic<unsigned> sleeping;
+        static std::mutex sleep_mutex;
+        static std::condition_variable wake;
+        static thread_local unsigned worker_index;
+
+        static void push(Task *task);
+        static Task *pop(void);
+        static Task *steal(void);
+        static Task *receive(void);
+        static void execute(Task *task);
+        static void loop(unsigned index);
+
+    public:
+
+        // Counts unfinished tasks. Tasks scheduled after a counter are held
+        // back until it reaches zero, which is how dependencies are expressed.
+        class Counter {
+
+            friend class Jobs;
+
+            std::atomic<int> value;
+            // the last decrement and done() share it, so the waiter cannot
+            // destroy the counter while a worker still releases its tasks
+            mutable std::mutex mutex;
+            std::vector<Task *> waiting;
+
+            void increment(void);
+            void decrement(void);
+
+        public:
+
+            inline Counter (void) : value(0) {}
+
+            Counter(const Counter &) = delete;
+            Counter &operator=(const Counter &) = delete;
+
+            inline bool done (void) const {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                return this->value.load(std::memory_order_acquire) == 0;
+            }
+
+        };
+
+        static void start(unsigned count = std::thread::hardware_concurrency());
+        static void stop(void);
+
+        static inline unsigned workerCount (void) { return Jobs::workers.size(); }
+        static inline bool isRunning (void) { return Jobs::running.load(std::memory_order_acquire); }
+
+        static void run(std::function<void(void)> work, Counter &done);
+        static void run(std::function<void(void)> work, Counter &done, Counter &after);
+
+        // for long jobs such as decoding or generating a stage, only a worker
+        // thread runs it, never the caller inside Jobs::wait
+        static void background(std::function<void(void)> work, Counter &done);
+
+        // runs other tasks until the counter reaches zero
+        static void wait(Counter &counter);
+
+        // splits [begin, end) into chunks of at most grain items and waits for all of them
+        static void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, const std::function<void(std::size_t, std::size_t)> &work);
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,329 @@
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <unordered_map>
+#include <cstdlib>
+#include "layout.h"
+
+namespace Breakout {
+
+    // splits on blanks, the v1 rows still go through a stringstream as before
+    static inline void split (const std::string &line, std::vector<std::string> &tokens) {
+        std::size_t begin = line.find_first_not_of(" \t");
+        while (begin != std::string::npos) {
+            const std::size_t end = line.find_first_of(" \t", begin);
+            tokens.push_back(line.substr(begin, end - begin));
+            begin = line.find_first_not_of(" \t", end);
+        }
+    }
+
+    constexpr unsigned long Layout::MaxRepeat, Layout::MaxCells;
+
+    // whole decimal number from 1 to Layout::MaxRepeat, nothing else around it
+    static inline bool count (const std::string &text, std::size_t begin, unsigned long &value) {
+        if (begin >= text.size() || text.size() - begin > 9 || text.find_first_not_of("0123456789", begin) != std::string::npos) {
+            return false;
+        }
+        value = std::strtoul(text.c_str() + begin, nullptr, 10);
+        return value > 0 && value <= Layout::MaxRepeat;
+    }
+
+    // "token*count", without the suffix the count is 1, false for a bad count
+    static inline bool repeat (const std::string &token, std::string &base, unsigned long &times) {
+        const std::size_t star = token.find_last_of('*');
+        if (star == std::string::npos || star == 0) {
+            times = 1;
+            base = token;
+            return true;
+        }
+        if (!count(token, star + 1, times)) {
+            return false;
+        }
+        base = token.substr(0, star);
+        return true;
+    }
+
+    bool Layout::load (const std::string &file) {
+
+        std::ifstream input(file, std::ios::in);
+
+        if (input.is_open()) {
+
+            bool ok;
+            std::string block, line = Layout::nextLine(input, ok);
+
+            this->version = 1;
+
+            if (line == "v2") {
+                this->version = 2;
+                line = Layout::nextLine(input, ok);
+            }
+
+            std::stringstream ss(line);
+
+            ss >> this->max_speed;
+
+            ss.str(Layout::nextLine(input, ok));
+            ss.seekg(0) >> this->min_speed;
+
+            ss.str(Layout::nextLine(input, ok));
+            ss.seekg(0) >> this->width;
+
+            ss.str(Layout::nextLine(input, ok));
+            ss.seekg(0) >> this->height;
+
+            ss.str(Layout::nextLine(input, ok));
+            ss.seekg(0) >> this->ball_x;
+
+            ss.str(Layout::nextLine(input, ok));
+            ss.seekg(0) >> this->ball_y;
+
+            this->music = Layout::nextLine(input, ok);
+
+            if (this->version == 2) {
+                if (!this->loadRows(input)) {
+                    this->rows.clear();
+                    return false;
+                }
+            } else {
+                for (line = Layout::nextLine(input, ok); ok; line = Layout::nextLine(input, ok)) {
+
+                    std::vector<std::string> row;
+
+                    ss.str(line);
+                    ss.seekg(0);
+
+                    while (ss.good()) {
+                        ss >> block;
+                        row.push_back(block);
+                    }
+
+                    this->rows.push_back(std::move(row));
+                }
+            }
+
+            input.close();
+
+            this->loaded = true;
+        }
+
+        return this->loaded;
+    }
+
+    bool Layout::loadRows (std::istream &input) {
+
+        bool ok;
+        unsigned long times, source, cells = 0;
+        std::string base;
+        std::unordered_map<std::string, std::string> palette;
+        std::vector<std::string> tokens;
+        std::vector<std::pair<const std::string *, unsigned long>> runs;
+
+        for (std::string line = Layout::nextLine(input, ok); ok; line = Layout::nextLine(input, ok)) {
+
+            tokens.clear();
+            split(line, tokens);
+
+            if (line[0] == '@') {
+                // "@alias token", an alias defined again replaces the old one
+                if (tokens.size() != 2) {
+                    return false;
+                }
+                palette[tokens[0].substr(1)] = tokens[1];
+                continue;
+            }
+
+            if (line[0] == '=') {
+                // "=" is the row above, "=k" row k counted from 0
+                if (!repeat(tokens[0], base, times)) {
+                    return false;
+                }
+                if (base.size() > 1) {
+                    // row 0 is a valid k, count() starts from 1
+                    if (base.find_first_not_of("0123456789", 1) != std::string::npos || base.size() > 10) {
+                        return false;
+                    }
+                    source = std::strtoul(base.c_str() + 1, nullptr, 10);
+                } else {
+                    source = this->rows.size() - 1;
+                }
+                if (source >= this->rows.size()) {
+                    return false;
+                }
+                // both at most MaxRepeat, the product cannot overflow
+                cells += this->rows[source].size() * times;
+                if (cells > Layout::MaxCells) {
+                    return false;
+                }
+                this->rows.reserve(this->rows.size() + times);
+                for (unsigned long i = 0; i < times; ++i) {
+                    this->rows.push_back(this->rows[source]);
+                }
+                continue;
+            }
+
+            std::size_t size = 0;
+
+            // resolved first so the row is allocated once
+            runs.clear();
+            for (std::string &token : tokens) {
+                if (!repeat(token, base, times)) {
+                    return false;
+                }
+                token = base;
+                const auto alias = palette.find(token);
+                runs.emplace_back(alias != palette.end() ? &alias->second : &token, times);
+                size += times;
+            }
+
+            cells += size;
+
+            if (size > Layout::MaxRepeat || cells > Layout::MaxCells) {
+                return false;
+            }
+
+            std::vector<std::string> row;
+            row.reserve(size);
+
+            for (const auto &run : runs) {
+                row.insert(row.end(), run.second, *run.first);
+            }
+
+            this->rows.push_back(std::move(row));
+        }
+
+        return true;
+    }
+
+    // a, b, ..., z, A, ..., Z, aa, ab, ...
+    static std::string aliasName (std::size_t index) {
+        static const char letters[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+        std::string name;
+        do {
+            name.insert(name.begin(), letters[index % 52]);
+            index = index / 52;
+        } while (index-- > 0);
+        return name;
+    }
+
+    bool Layout::save (const std::string &file, unsigned format) const {
+
+        std::ofstream output(file, std::ios::out | std::ios::trunc);
+
+        if (!output.is_open()) {
+            return false;
+        }
+
+        if (format == 2) {
+            output << "v2\n\n";
+        }
+
+        output.precision(10);
+        output << "> velocidade maxima\n" << this->max_speed << "\n\n"
+            << "> velocidade minima\n" << this->min_speed << "\n\n"
+            << "> largura do bloco\n" << this->width << "\n\n"
+            << "> altura do bloco\n" << this->height << "\n\n"
+            << "> posicao x da bola\n" << this->ball_x << "\n\n"
+            << "> posicao y da bola\n" << this->ball_y << "\n\n"
+            << "> nome da musica (relativo a pasta audio)\n" << this->music << "\n\n";
+
+        if (format == 2) {
+            this->saveRows(output);
+            return static_cast<bool>(output);
+        }
+
+        output << "> cada bloco da fase\n";
+
+        for (const auto &row : this->rows) {
+            // a blank line would be skipped when reading, an empty row is written as a gap
+            if (row.empty()) {
+                output << "-";
+            }
+            for (std::size_t i = 0; i < row.size(); ++i) {
+                output << (i ? " " : "") << row[i];
+            }
+            output << "\n";
+        }
+
+        return static_cast<bool>(output);
+    }
+
+    void Layout::saveRows (std::ostream &output) const {
+
+        std::unordered_map<std::string, std::size_t> uses;
+        std::vector<std::string> tokens;
+
+        for (const auto &row : this->rows) {
+            for (const auto &token : row) {
+                if (token != "-" && !uses[token]++) {
+                    tokens.push_back(token);
+                }
+            }
+        }
+
+        // the most used tokens get the shortest aliases
+        std::stable_sort(tokens.begin(), tokens.end(), [ &uses ] (const std::string &a, const std::string &b) {
+            return uses[a] > uses[b];
+        });
+
+        std::unordered_map<std::string, std::string> aliases;
+
+        output << "> paleta: @apelido bloco\n";
+        for (std::size_t i = 0; i < tokens.size(); ++i) {
+            aliases[tokens[i]] = aliasName(i);
+            output << '@' << aliases[tokens[i]] << ' ' << tokens[i] << "\n";
+        }
+
+        output << "\n> cada linha da fase: bloco*repeticoes, = repete a linha anterior, =k repete a linha k\n";
+
+        std::map<std::vector<std::string>, std::size_t> seen;
+
+        for (std::size_t i = 0; i < this->rows.size(); ) {
+
+            const auto &row = this->rows[i];
+            std::size_t same = 1;
+
+            if (i > 0 && row == this->rows[i - 1]) {
+                while (i + same < this->rows.size() && this->rows[i + same] == row) {
+                    ++same;
+                }
+                output << '=';
+                if (same > 1) {
+                    output << '*' << same;
+                }
+                output << "\n";
+                i += same;
+                continue;
+            }
+
+            const auto earlier = seen.find(row);
+
+            if (earlier != seen.end()) {
+                output << '=' << earlier->second << "\n";
+            } else {
+
+                seen.emplace(row, i);
+
+                if (row.empty()) {
+                    output << "-";
+                }
+
+                for (std::size_t j = 0; j < row.size(); j += same) {
+                    same = 1;
+                    while (j + same < row.size() && row[j + same] == row[j]) {
+                        ++same;
+                    }
+                    output << (j ? " " : "") << (row[j] == "-" ? row[j] : aliases[row[j]]);
+                    if (same > 1) {
+                        output << '*' << same;
+                    }
+                }
+
+                output << "\n";
+            }
+
+            ++i;
+        }
+    }
+
+}
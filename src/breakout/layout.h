@@ -0,0 +1,81 @@
+#ifndef SRC_BREAKOUT_LAYOUT_H_
+#define SRC_BREAKOUT_LAYOUT_H_
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <algorithm>
+#include <cctype>
+
+namespace Breakout {
+
+    // Contents of a .brk file. Reading it touches no engine state, so
+    // several stages can be parsed at the same time.
+    //
+    // A file whose first line is "v2" has the same header. Its rows may use
+    // "@alias token" lines to name a token, "token*N" for N equal tokens in
+    // a row, "=" to repeat the row above and "=k" to repeat row k, counted
+    // from 0. Any of these takes a "*N" count, N from 1 to MaxRepeat. A
+    // malformed palette line, count or reference fails the whole load, so
+    // does a file that expands to more than MaxCells tokens. Both versions load
+    // into the same expanded rows.
+    class Layout {
+
+        static inline bool not_space (int c) {
+        	return !isspace(c);
+        }
+
+        static inline std::string &ltrim (std::string &s) {
+        	s.erase(s.begin(), find_if(s.begin(), s.end(), not_space));
+        	return s;
+        }
+
+        static inline std::string &rtrim (std::string &s) {
+        	s.erase(find_if(s.rbegin(), s.rend(), not_space).base(), s.end());
+        	return s;
+        }
+
+        static inline std::string &trim (std::string &s) {
+        	return ltrim(rtrim(s));
+        }
+
+        static std::string nextLine (
+        	std::istream &in,
+            bool &ok
+        ) {
+        	std::string line = "";
+        	do {
+        		std::getline(in, line);
+        		line = line.substr(0, line.find_first_of('>'));
+        	} while (!trim(line).size() && in.good());
+
+            ok = line.size() > 0;
+
+        	return line;
+        }
+
+        bool loadRows(std::istream &input);
+        void saveRows(std::ostream &output) const;
+
+    public:
+
+        // longest row and longest run of repeated rows a v2 file may expand to
+        static constexpr unsigned long MaxRepeat = 4096;
+        // tokens in all rows of a v2 file together, a few short lines can
+        // otherwise repeat a long row into hundreds of millions of strings
+        static constexpr unsigned long MaxCells = 1ul << 20;
+
+        bool loaded = false;
+        unsigned version = 1;
+        double max_speed = 0.0, min_speed = 0.0, width = 0.0, height = 0.0, ball_x = 0.0, ball_y = 0.0;
+        std::string music;
+        std::vector<std::vector<std::string>> rows;
+
+        bool load(const std::string &file);
+        bool save(const std::string &file, unsigned format = 1) const;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,141 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "log.h"
+#include "memory.h"
+
+namespace Breakout {
+
+    constexpr std::size_t Log::ArgumentBytes;
+    Log::Level Log::levels[Log::CategorySize] = { Log::Info, Log::Info, Log::Info, Log::Info, Log::Info };
+    Ring<Log::Record, 1024> Log::records;
+    std::atomic_flag Log::producing = ATOMIC_FLAG_INIT;
+    std::mutex Log::printing;
+    std::thread Log::thread;
+    std::atomic<bool> Log::running(false);
+    std::atomic<unsigned long> Log::dropped(0);
+    std::ostream *Log::output = nullptr;
+
+    static const char *const level_names[] = { "debug", "info", "warning", "error", "off" };
+    static const char *const category_names[] = { "general", "game", "physics", "audio", "performance" };
+
+    static const double origin = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    double Log::now (void) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count() - origin;
+    }
+
+    bool Log::parseLevel (const std::string &name, Level &level) {
+        for (int i = Log::Debug; i <= Log::Off; ++i) {
+            if (name == level_names[i]) {
+                level = static_cast<Level>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Log::parseCategory (const std::string &name, Category &category) {
+        for (int i = 0; i < Log::CategorySize; ++i) {
+            if (name == category_names[i]) {
+                category = static_cast<Category>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Log::push (Record &&record) {
+
+        if (!Log::isRunning()) {
+            Log::print(record);
+            return;
+        }
+
+        while (Log::producing.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        const bool pushed = Log::records.push(std::move(record));
+        Log::producing.clear(std::memory_order_release);
+
+        // a full ring never stalls the frame for chatter, it is counted instead,
+        // warnings and errors are rare enough to print right here
+        if (!pushed) {
+            if (record.level >= Log::Warning) {
+                std::lock_guard<std::mutex> lock(Log::printing);
+                Log::print(record);
+            } else {
+                Log::dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void Log::print (const Record &record) {
+
+        std::ostream &out = Log::output ? *Log::output : std::clog;
+
+        const std::streamsize precision = out.precision(3);
+        out << '[' << std::fixed << record.time << std::defaultfloat << std::setprecision(precision) << "] "
+            << level_names[record.level] << ' ' << category_names[record.category] << ": ";
+
+        if (record.formatter) {
+            record.formatter(out, record.format, record.arguments);
+        } else {
+            out << record.text;
+        }
+
+        out << '\n';
+    }
+
+    void Log::start (std::ostream &out) {
+        if (!Log::isRunning()) {
+            Log::output = &out;
+            Memory::add(Memory::Bookkeeping, sizeof(Log::records));
+            Log::running.store(true, std::memory_order_release);
+            Log::thread = std::thread(Log::loop);
+        }
+    }
+
+    void Log::stop (void) {
+        if (Log::isRunning()) {
+            Log::running.store(false, std::memory_order_release);
+            Log::thread.join();
+            Memory::remove(Memory::Bookkeeping, sizeof(Log::records));
+
+            Record record;
+            while (Log::records.pop(record)) {
+                Log::print(record);
+            }
+
+            const unsigned long lost = Log::dropped.exchange(0, std::memory_order_relaxed);
+            if (lost) {
+                *Log::output << "[log] " << lost << " records dropped" << std::endl;
+            }
+        }
+    }
+
+    void Log::loop (void) {
+
+        Record record;
+
+        for (;;) {
+            // read before draining, so nothing pushed before stop() is lost
+            const bool stopping = !Log::isRunning();
+
+            {
+                std::lock_guard<std::mutex> lock(Log::printing);
+                while (Log::records.pop(record)) {
+                    Log::print(record);
+                }
+                Log::output->flush();
+            }
+
+            if (stopping) {
+                break;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+}
@@ -0,0 +1,202 @@
+#ifndef SRC_BREAKOUT_LOG_H_
+#define SRC_BREAKOUT_LOG_H_
+
+#include <string>
+#include <ostream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include <type_traits>
+#include "ring.h"
+
+// Arguments are only evaluated when the level and category are enabled.
+// The format is kept as a pointer and "{}" is replaced on the writer
+// thread, so it and any const char * argument must be literals.
+#define BREAKOUT_LOG(level, category, ...) \
+    do { \
+        if (Breakout::Log::enabled(Breakout::Log::level, Breakout::Log::category)) { \
+            Breakout::Log::write(Breakout::Log::level, Breakout::Log::category, __VA_ARGS__); \
+        } \
+    } while (0)
+
+namespace Breakout {
+
+    // Records are copied into a ring with their arguments still packed and
+    // formatted by a background thread. Producers on different threads take
+    // turns through a spin flag, the writer never holds it.
+    class Log {
+
+    public:
+
+        enum Level : int {
+            Debug = 0,
+            Info = 1,
+            Warning = 2,
+            Error = 3,
+            Off = 4
+        };
+
+        enum Category : int {
+            General = 0,
+            Game = 1,
+            Physics = 2,
+            Audio = 3,
+            Performance = 4,
+
+            CategorySize = 5
+        };
+
+        static constexpr std::size_t ArgumentBytes = 48;
+
+    private:
+
+        typedef void (*Formatter)(std::ostream &out, const char *format, const unsigned char *arguments);
+
+        struct Record {
+            Level level = Level::Info;
+            Category category = Category::General;
+            double time = 0.0;
+            Formatter formatter = nullptr;
+            const char *format = nullptr;
+            unsigned char arguments[Log::ArgumentBytes];
+            // already formatted text, for output built by the caller
+            std::string text;
+        };
+
+        static Level levels[Category::CategorySize];
+        static Ring<Record, 1024> records;
+        static std::atomic_flag producing;
+        // held by whoever prints, the writer or a producer that found the ring full
+        static std::mutex printing;
+        static std::thread thread;
+        static std::atomic<bool> running;
+        static std::atomic<unsigned long> dropped;
+        static std::ostream *output;
+
+        template <typename... Args>
+        struct Size;
+
+        template <typename T, typename... Rest>
+        struct Size<T, Rest...> {
+            static constexpr std::size_t value = sizeof(T) + Size<Rest...>::value;
+        };
+
+        template <typename... Args>
+        struct Loggable;
+
+        template <typename T, typename... Rest>
+        struct Loggable<T, Rest...> {
+            static constexpr bool value = (std::is_arithmetic<T>::value || std::is_same<T, const char *>::value) && Loggable<Rest...>::value;
+        };
+
+        static inline void pack (unsigned char *) {}
+
+        template <typename T, typename... Rest>
+        static inline void pack (unsigned char *out, T value, Rest... rest) {
+            std::memcpy(out, &value, sizeof(T));
+            Log::pack(out + sizeof(T), rest...);
+        }
+
+        template <typename... Args>
+        struct Unpack;
+
+        template <typename T, typename... Rest>
+        struct Unpack<T, Rest...> {
+            static inline void print (std::ostream &out, const char *format, const unsigned char *arguments) {
+
+                const char *field = std::strstr(format, "{}");
+
+                if (!field) {
+                    out << format;
+                    return;
+                }
+
+                T value;
+                std::memcpy(&value, arguments, sizeof(T));
+                out.write(format, field - format) << value;
+
+                Unpack<Rest...>::print(out, field + 2, arguments + sizeof(T));
+            }
+        };
+
+        template <typename... Args>
+        static void formatter (std::ostream &out, const char *format, const unsigned char *arguments) {
+            Unpack<Args...>::print(out, format, arguments);
+        }
+
+        static double now(void);
+        static void push(Record &&record);
+        static void print(const Record &record);
+        static void loop(void);
+
+    public:
+
+        static inline bool enabled (Level level, Category category) { return level >= Log::levels[category]; }
+
+        static inline void setLevel (Level level) {
+            for (Level &current : Log::levels) {
+                current = level;
+            }
+        }
+
+        static inline void setLevel (Category category, Level level) { Log::levels[category] = level; }
+
+        static bool parseLevel(const std::string &name, Level &level);
+        static bool parseCategory(const std::string &name, Category &category);
+
+        template <typename... Args>
+        static inline void write (Level level, Category category, const char *format, Args... args) {
+
+            static_assert(Loggable<typename std::decay<Args>::type...>::value, "log arguments must be numbers or string literals");
+            static_assert(Size<typename std::decay<Args>::type...>::value <= Log::ArgumentBytes, "too many log arguments");
+
+            Record record;
+            record.level = level;
+            record.category = category;
+            record.time = Log::now();
+            record.formatter = &Log::formatter<typename std::decay<Args>::type...>;
+            record.format = format;
+            Log::pack(record.arguments, static_cast<typename std::decay<Args>::type>(args)...);
+            Log::push(std::move(record));
+        }
+
+        // for text the caller had to build anyway, such as object dumps
+        static inline void text (Level level, Category category, std::string text) {
+            if (Log::enabled(level, category)) {
+                Record record;
+                record.level = level;
+                record.category = category;
+                record.time = Log::now();
+                record.text = std::move(text);
+                Log::push(std::move(record));
+            }
+        }
+
+        // without a running writer records are printed by the caller
+        static void start(std::ostream &out);
+        static void stop(void);
+
+        static inline bool isRunning (void) { return Log::running.load(std::memory_order_acquire); }
+        static inline unsigned long droppedRecords (void) { return Log::dropped.load(std::memory_order_relaxed); }
+
+    };
+
+    template <>
+    struct Log::Size<> {
+        static constexpr std::size_t value = 0;
+    };
+
+    template <>
+    struct Log::Loggable<> {
+        static constexpr bool value = true;
+    };
+
+    template <>
+    struct Log::Unpack<> {
+        static inline void print (std::ostream &out, const char *format, const unsigned char *) { out << format; }
+    };
+
+}
+
+#endif
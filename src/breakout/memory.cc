@@ -0,0 +1,121 @@
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <unistd.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <GL/glew.h>
+#include "memory.h"
+
+namespace Breakout {
+
+    const char *const Memory::names[Memory::CategorySize] = {
+        "music", "effects", "textures", "stages", "bookkeeping"
+    };
+
+    std::atomic<std::size_t> Memory::values[Memory::CategorySize];
+
+    std::size_t Memory::total (void) {
+        std::size_t sum = 0;
+        for (int i = 0; i < Memory::CategorySize; ++i) {
+            sum += Memory::bytes(static_cast<Category>(i));
+        }
+        return sum;
+    }
+
+    std::size_t Memory::residentBytes (void) {
+        std::ifstream statm("/proc/self/statm");
+        std::size_t size = 0, resident = 0;
+        if (statm >> size >> resident) {
+            return resident * sysconf(_SC_PAGESIZE);
+        }
+        return 0;
+    }
+
+    static inline uint32_t little32 (const unsigned char *bytes) {
+        return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    std::size_t Memory::soundBytes (const std::string &path) {
+
+        std::ifstream in(path, std::ios::binary);
+        unsigned char page[27 + 255 + 30];
+
+        // the first page holds the Vorbis identification header alone
+        if (!in.read(reinterpret_cast<char *>(page), 27) || std::string(reinterpret_cast<char *>(page), 4) != "OggS") {
+            return 0;
+        }
+
+        const unsigned segments = page[26];
+
+        if (!in.read(reinterpret_cast<char *>(page + 27), segments + 16) || page[27 + segments] != 1) {
+            return 0;
+        }
+
+        const unsigned char *identification = page + 27 + segments;
+        const unsigned file_channels = identification[11];
+        const uint32_t file_rate = little32(identification + 12);
+
+        if (!file_channels || !file_rate) {
+            return 0;
+        }
+
+        // the granule position of the last page is the length in frames
+        in.seekg(0, std::ios::end);
+        const std::streamoff size = in.tellg();
+        const std::streamoff tail = std::min<std::streamoff>(size, 65536);
+        std::string end(tail, '\0');
+
+        in.seekg(size - tail);
+        if (!in.read(&end[0], tail)) {
+            return 0;
+        }
+
+        const std::size_t last = end.rfind("OggS");
+        if (last == std::string::npos || last + 14 > end.size()) {
+            return 0;
+        }
+
+        const unsigned char *granule = reinterpret_cast<const unsigned char *>(end.data() + last + 6);
+        const uint64_t frames = little32(granule) | (static_cast<uint64_t>(little32(granule + 4)) << 32);
+
+        int rate = file_rate, channels = file_channels;
+        Uint16 format = AUDIO_S16SYS;
+
+        // SDL_mixer converts everything to the device when loading
+        Mix_QuerySpec(&rate, &format, &channels);
+
+        return static_cast<std::size_t>(frames * static_cast<double>(rate) / file_rate) * channels * ((format & 0xFF) / 8);
+    }
+
+    std::size_t Memory::textureBytes (unsigned texture) {
+
+        GLint previous = 0, width = 0, height = 0;
+
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+        glBindTexture(GL_TEXTURE_2D, previous);
+
+        return static_cast<std::size_t>(width) * height * 4;
+    }
+
+    void Memory::report (std::ostream &out) {
+
+        const std::size_t resident = Memory::residentBytes(), accounted = Memory::total();
+
+        out << "Memory (KB):" << std::endl;
+
+        for (int i = 0; i < Memory::CategorySize; ++i) {
+            out << "  " << std::left << std::setw(12) << Memory::names[i] << std::right << std::setw(10)
+                << Memory::bytes(static_cast<Category>(i)) / 1024 << std::endl;
+        }
+
+        out << "  " << std::left << std::setw(12) << "other" << std::right << std::setw(10)
+            << (resident > accounted ? resident - accounted : 0) / 1024 << std::endl;
+        out << "  " << std::left << std::setw(12) << "resident" << std::right << std::setw(10)
+            << resident / 1024 << std::endl;
+    }
+
+}
@@ -0,0 +1,84 @@
+#ifndef SRC_BREAKOUT_MEMORY_H_
+#define SRC_BREAKOUT_MEMORY_H_
+
+#include <string>
+#include <atomic>
+#include <ostream>
+#include <cstddef>
+
+namespace Breakout {
+
+    // Bytes each subsystem holds, accounted by whoever loads or frees them.
+    // Memory::report compares the sum with the resident set, what is left
+    // belongs to the engine, the libraries and the code itself.
+    class Memory {
+
+    public:
+
+        enum Category : int {
+            Music = 0,
+            Effects = 1,
+            Textures = 2,
+            Stages = 3,
+            Bookkeeping = 4,
+
+            CategorySize = 5
+        };
+
+        static const char *const names[Category::CategorySize];
+
+    private:
+
+        static std::atomic<std::size_t> values[Category::CategorySize];
+
+    public:
+
+        static inline void add (Category category, std::size_t bytes) { Memory::values[category].fetch_add(bytes, std::memory_order_relaxed); }
+        static inline void remove (Category category, std::size_t bytes) { Memory::values[category].fetch_sub(bytes, std::memory_order_relaxed); }
+        static inline std::size_t bytes (Category category) { return Memory::values[category].load(std::memory_order_relaxed); }
+
+        static std::size_t total(void);
+        static std::size_t residentBytes(void);
+
+        // PCM size of an Ogg Vorbis file once decoded to the audio device
+        // format, read from its headers without decoding it
+        static std::size_t soundBytes(const std::string &path);
+
+        // level 0 of a 2D texture as the driver reports it, RGBA8 assumed,
+        // the name is a GLuint kept as unsigned so only memory.cc needs GL
+        static std::size_t textureBytes(unsigned texture);
+
+        static void report(std::ostream &out);
+
+        // Follows a size that changes over time, such as an arena, and gives
+        // it back when destroyed.
+        class Account {
+
+            const Category category;
+            std::size_t current = 0;
+
+        public:
+
+            inline Account (Category _category) : category(_category) {}
+            inline ~Account (void) { Memory::remove(this->category, this->current); }
+
+            Account(const Account &) = delete;
+            Account &operator=(const Account &) = delete;
+
+            inline void set (std::size_t bytes) {
+                if (bytes != this->current) {
+                    Memory::add(this->category, bytes);
+                    Memory::remove(this->category, this->current);
+                    this->current = bytes;
+                }
+            }
+
+            inline std::size_t get (void) const { return this->current; }
+
+        };
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,174 @@
+#include <chrono>
+#include <algorithm>
+#include "metrics.h"
+#include "memory.h"
+
+namespace Breakout {
+
+    constexpr double Metrics::DefaultInterval;
+    Ring<Metrics::Frame, 1024> Metrics::frames;
+    std::ofstream Metrics::output;
+    std::thread Metrics::thread;
+    std::atomic<bool> Metrics::running(false);
+    std::atomic<unsigned long> Metrics::dropped(0);
+    double Metrics::interval = Metrics::DefaultInterval;
+    bool Metrics::csv = false;
+
+    static const char *const columns[] = {
+        "time", "frames", "tick_rate", "frame_p50_ms", "frame_p95_ms", "frame_p99_ms", "frame_max_ms",
+        "simulation_ms", "render_ms", "contacts_per_tick", "hits_per_tick", "bonuses", "voices", "objects", "timers",
+        "draw_calls_per_frame", "state_changes_per_frame", "texture_binds_per_frame", "upload_bytes_per_frame",
+        "allocations_per_frame", "music_bytes", "effect_bytes", "texture_bytes", "stage_bytes",
+        "bookkeeping_bytes", "idle_ms", "idle_budget_ms", "culled_borders_per_frame", "rss_bytes", "dropped"
+    };
+
+    static inline double now (void) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool Metrics::start (const std::string &path, double _interval) {
+
+        if (Metrics::isRunning()) {
+            return true;
+        }
+
+        Metrics::output.open(path, std::ios::out | std::ios::trunc);
+
+        if (!Metrics::output.is_open()) {
+            return false;
+        }
+
+        // byte counts stay whole numbers
+        Metrics::output.precision(12);
+        Metrics::interval = std::max(_interval, 0.01);
+        Metrics::csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+
+        if (Metrics::csv) {
+            for (std::size_t i = 0; i < sizeof(columns) / sizeof(columns[0]); ++i) {
+                Metrics::output << (i ? "," : "") << columns[i];
+            }
+            Metrics::output << std::endl;
+        }
+
+        Memory::add(Memory::Bookkeeping, sizeof(Metrics::frames));
+        Metrics::running.store(true, std::memory_order_release);
+        Metrics::thread = std::thread(Metrics::loop);
+
+        return true;
+    }
+
+    void Metrics::stop (void) {
+        if (Metrics::isRunning()) {
+            Metrics::running.store(false, std::memory_order_release);
+            Metrics::thread.join();
+            Memory::remove(Memory::Bookkeeping, sizeof(Metrics::frames));
+            Metrics::output.close();
+        }
+    }
+
+    void Metrics::loop (void) {
+
+        const double origin = now();
+        double start = origin;
+        std::vector<Frame> window;
+        Frame frame;
+
+        while (true) {
+
+            const bool stopping = !Metrics::isRunning();
+
+            while (Metrics::frames.pop(frame)) {
+                window.push_back(frame);
+            }
+
+            const double current = now();
+
+            if (current - start >= Metrics::interval || (stopping && !window.empty())) {
+                Metrics::write(window, current - origin, current - start);
+                window.clear();
+                start = current;
+            }
+
+            if (stopping) {
+                break;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    void Metrics::write (std::vector<Frame> &window, double time, double elapsed) {
+
+        const std::size_t count = window.size();
+        double sum[Stats::Counter::CounterSize] = { 0.0 };
+        uint64_t max[Stats::Counter::CounterSize] = { 0 };
+        std::vector<uint64_t> times;
+
+        times.reserve(count);
+
+        for (const Frame &frame : window) {
+            for (int i = 0; i < Stats::Counter::CounterSize; ++i) {
+                sum[i] += frame.values[i];
+                max[i] = std::max(max[i], frame.values[i]);
+            }
+            times.push_back(frame.values[Stats::FrameTime]);
+        }
+
+        std::sort(times.begin(), times.end());
+
+        auto percentile = [ &times ] (double p) {
+            return times.empty() ? 0.0 : times[std::min<std::size_t>(times.size() - 1, p * times.size())] / 1000.0;
+        };
+        auto mean = [ &sum, count ] (Stats::Counter counter) {
+            return count ? sum[counter] / count : 0.0;
+        };
+
+        const Frame *last = count ? &window.back() : nullptr;
+        const double values[] = {
+            time,
+            static_cast<double>(count),
+            count / elapsed,
+            percentile(0.5),
+            percentile(0.95),
+            percentile(0.99),
+            max[Stats::FrameTime] / 1000.0,
+            mean(Stats::SimulationTime) / 1000.0,
+            mean(Stats::RenderTime) / 1000.0,
+            mean(Stats::Contacts),
+            mean(Stats::Hits),
+            static_cast<double>(max[Stats::Bonuses]),
+            static_cast<double>(max[Stats::AudioVoices]),
+            last ? static_cast<double>(last->values[Stats::Objects]) : 0.0,
+            last ? static_cast<double>(last->values[Stats::Timers]) : 0.0,
+            mean(Stats::DrawCalls),
+            mean(Stats::StateChanges),
+            mean(Stats::TextureBinds),
+            mean(Stats::UploadBytes),
+            mean(Stats::Allocations),
+            static_cast<double>(Memory::bytes(Memory::Music)),
+            static_cast<double>(Memory::bytes(Memory::Effects)),
+            static_cast<double>(Memory::bytes(Memory::Textures)),
+            static_cast<double>(Memory::bytes(Memory::Stages)),
+            static_cast<double>(Memory::bytes(Memory::Bookkeeping)),
+            mean(Stats::IdleTime) / 1000.0,
+            mean(Stats::IdleBudget) / 1000.0,
+            mean(Stats::CulledBorders),
+            static_cast<double>(Memory::residentBytes()),
+            static_cast<double>(Metrics::dropped.exchange(0, std::memory_order_relaxed))
+        };
+
+        static_assert(sizeof(values) / sizeof(values[0]) == sizeof(columns) / sizeof(columns[0]), "one column per value");
+
+        for (std::size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+            if (Metrics::csv) {
+                Metrics::output << (i ? "," : "") << values[i];
+            } else {
+                Metrics::output << (i ? ",\"" : "{\"") << columns[i] << "\":" << values[i];
+            }
+        }
+
+        Metrics::output << (Metrics::csv ? "\n" : "}\n");
+        Metrics::output.flush();
+    }
+
+}
@@ -0,0 +1,62 @@
+#ifndef SRC_BREAKOUT_METRICS_H_
+#define SRC_BREAKOUT_METRICS_H_
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include "ring.h"
+#include "stats.h"
+
+namespace Breakout {
+
+    // Time series for soak runs. The frame loop only copies the latched
+    // Stats into a ring, a background thread aggregates them and writes one
+    // line per interval, CSV when the file ends in .csv and JSON lines
+    // otherwise.
+    class Metrics {
+
+        struct Frame {
+            uint64_t values[Stats::Counter::CounterSize];
+        };
+
+        static Ring<Frame, 1024> frames;
+        static std::ofstream output;
+        static std::thread thread;
+        static std::atomic<bool> running;
+        static std::atomic<unsigned long> dropped;
+        static double interval;
+        static bool csv;
+
+        static void loop(void);
+        static void write(std::vector<Frame> &window, double time, double elapsed);
+
+    public:
+
+        static constexpr double DefaultInterval = 1.0;
+
+        static bool start(const std::string &path, double interval = Metrics::DefaultInterval);
+        static void stop(void);
+
+        static inline bool isRunning (void) { return Metrics::running.load(std::memory_order_acquire); }
+
+        // called once per frame after Stats::frame, never waits on the writer
+        static inline void frame (void) {
+            if (Metrics::isRunning()) {
+                Frame frame;
+                for (int i = 0; i < Stats::Counter::CounterSize; ++i) {
+                    frame.values[i] = Stats::get(static_cast<Stats::Counter>(i));
+                }
+                if (!Metrics::frames.push(frame)) {
+                    Metrics::dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,262 @@
+#include <chrono>
+#include <algorithm>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "mixer.h"
+#include "profiler.h"
+#include "memory.h"
+
+namespace Breakout {
+
+    constexpr unsigned Mixer::MaxVoices;
+    std::vector<std::unique_ptr<Mixer::Sample>> Mixer::samples;
+    std::atomic<std::size_t> Mixer::sample_bytes(0);
+    Mixer::Voice Mixer::voices[Mixer::MaxVoices] = { };
+    std::vector<float> Mixer::accumulator;
+    Ring<Mixer::Command, 128> Mixer::commands;
+    int Mixer::frequency = 0, Mixer::channels = 0;
+    bool Mixer::opened = false, Mixer::own_device = false;
+    unsigned long Mixer::next_id = 0;
+    std::atomic<unsigned long> Mixer::callbacks(0), Mixer::total_ns(0), Mixer::last_ns(0), Mixer::max_ns(0);
+    std::atomic<unsigned> Mixer::active_voices(0);
+
+    bool Mixer::open (void) {
+
+        int _frequency, _channels;
+        Uint16 format;
+
+        if (Mixer::opened) {
+            return true;
+        }
+
+        // works the same with SDL_AUDIODRIVER=dummy, the device is only discarding the output
+        if (!Mix_QuerySpec(&_frequency, &format, &_channels)) {
+            if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 1024) != 0) {
+                return false;
+            }
+            Mixer::own_device = true;
+            Mix_QuerySpec(&_frequency, &format, &_channels);
+        }
+
+        if (format != AUDIO_S16SYS) {
+            if (Mixer::own_device) {
+                Mix_CloseAudio();
+                Mixer::own_device = false;
+            }
+            return false;
+        }
+
+        Mixer::frequency = _frequency;
+        Mixer::channels = _channels;
+        Mixer::accumulator.resize(16384);
+        Mixer::opened = true;
+
+        Mix_SetPostMix(Mixer::postMix, nullptr);
+
+        return true;
+    }
+
+    void Mixer::close (void) {
+
+        if (Mixer::opened) {
+
+            Mix_SetPostMix(nullptr, nullptr);
+
+            if (Mixer::own_device) {
+                Mix_CloseAudio();
+                Mixer::own_device = false;
+            }
+
+            for (auto &voice : Mixer::voices) {
+                voice.active = false;
+            }
+
+            Mixer::samples.clear();
+            Memory::remove(Memory::Effects, Mixer::sample_bytes.exchange(0, std::memory_order_relaxed));
+            Mixer::opened = false;
+        }
+    }
+
+    const Mixer::Sample *Mixer::load (const std::string &path) {
+
+        Mix_Chunk *chunk;
+        Sample *sample;
+
+        if (!Mixer::opened || !(chunk = Mix_LoadWAV(path.c_str()))) {
+            return nullptr;
+        }
+
+        // SDL_mixer already converted the chunk to the device rate and format,
+        // padding lets the mixing loop always read whole vectors
+        sample = new Sample;
+        sample->frames = chunk->alen / (sizeof(int16_t) * Mixer::channels);
+        sample->pcm.assign(sample->frames * Mixer::channels + 8, 0);
+        std::copy_n(reinterpret_cast<const int16_t *>(chunk->abuf), sample->frames * Mixer::channels, sample->pcm.begin());
+
+        Mix_FreeChunk(chunk);
+
+        Mixer::samples.emplace_back(sample);
+        Mixer::sample_bytes.fetch_add(sample->pcm.size() * sizeof(int16_t), std::memory_order_relaxed);
+        Memory::add(Memory::Effects, sample->pcm.size() * sizeof(int16_t));
+
+        return sample;
+    }
+
+    unsigned long Mixer::play (const Sample *sample, int volume) {
+
+        const unsigned long id = ++Mixer::next_id;
+
+        if (!sample || !Mixer::commands.push({ sample, id, std::min(std::max(volume, 0), MIX_MAX_VOLUME) / static_cast<float>(MIX_MAX_VOLUME), 0 })) {
+            return 0;
+        }
+
+        return id;
+    }
+
+    void Mixer::fadeOut (unsigned long id, unsigned ms) {
+        if (id) {
+            Mixer::commands.push({ nullptr, id, 0.0f, ms });
+        }
+    }
+
+    void Mixer::apply (const Command &command) {
+
+        if (command.sample) {
+
+            Voice *voice = std::find_if(std::begin(Mixer::voices), std::end(Mixer::voices), [] (const Voice &v) {
+                return !v.active;
+            });
+
+            if (voice == std::end(Mixer::voices)) {
+                voice = std::min_element(std::begin(Mixer::voices), std::end(Mixer::voices), [] (const Voice &a, const Voice &b) {
+                    return a.id < b.id;
+                });
+            }
+
+            *voice = { command.sample, command.id, 0, command.volume, command.volume, 0.0f, true };
+
+        } else {
+
+            for (auto &voice : Mixer::voices) {
+                if (voice.active && voice.id == command.id) {
+                    const float frames = std::max(command.fade_ms * Mixer::frequency / 1000.0f, 1.0f);
+                    voice.target = 0.0f;
+                    voice.step = -voice.gain / frames;
+                }
+            }
+        }
+    }
+
+    void Mixer::mix (int16_t *stream, std::size_t length) {
+
+        BREAKOUT_ZONE("mix");
+
+        Command command;
+        unsigned active = 0;
+        const std::size_t padded = (length + 3) & ~static_cast<std::size_t>(3);
+        const float group_frames = 4.0f / Mixer::channels;
+
+        while (Mixer::commands.pop(command)) {
+            Mixer::apply(command);
+        }
+
+        if (Mixer::accumulator.size() < padded) {
+            Mixer::accumulator.resize(padded);
+        }
+
+        float *acc = Mixer::accumulator.data();
+        std::fill_n(acc, padded, 0.0f);
+
+        for (auto &voice : Mixer::voices) {
+
+            if (!voice.active) {
+                continue;
+            }
+
+            const int16_t *src = voice.sample->pcm.data() + voice.position * Mixer::channels;
+            const std::size_t
+                remaining = (voice.sample->frames - voice.position) * Mixer::channels,
+                count = std::min(length, remaining);
+
+            float gain = voice.gain;
+
+            ++active;
+
+            // the envelope advances once per group of four samples
+            for (std::size_t i = 0; i < count; i += 4) {
+#ifdef __SSE2__
+                const __m128i s = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + i));
+                const __m128 f = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+                _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(f, _mm_set1_ps(gain))));
+#else
+                for (std::size_t j = i; j < i + 4; ++j) {
+                    acc[j] += src[j] * gain;
+                }
+#endif
+                if (voice.step != 0.0f) {
+                    gain = std::max(gain + voice.step * group_frames, voice.target);
+                }
+            }
+
+            voice.gain = gain;
+            voice.position += count / Mixer::channels;
+
+            if (voice.position >= voice.sample->frames || (voice.step < 0.0f && gain <= voice.target)) {
+                voice.active = false;
+            }
+        }
+
+        Mixer::active_voices.store(active, std::memory_order_relaxed);
+
+        if (!active) {
+            return;
+        }
+
+        std::size_t i = 0;
+
+#ifdef __SSE2__
+        for (; i + 8 <= length; i += 8) {
+            const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(stream + i));
+            const __m128
+                low = _mm_add_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16)), _mm_loadu_ps(acc + i)),
+                high = _mm_add_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16)), _mm_loadu_ps(acc + i + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(stream + i), _mm_packs_epi32(_mm_cvtps_epi32(low), _mm_cvtps_epi32(high)));
+        }
+#endif
+
+        for (; i < length; ++i) {
+            const float value = stream[i] + acc[i];
+            stream[i] = static_cast<int16_t>(std::min(std::max(value, -32768.0f), 32767.0f));
+        }
+    }
+
+    void Mixer::postMix (void *udata, uint8_t *stream, int length) {
+
+        const auto start = std::chrono::steady_clock::now();
+
+        Mixer::mix(reinterpret_cast<int16_t *>(stream), length / sizeof(int16_t));
+
+        const unsigned long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        Mixer::callbacks.fetch_add(1, std::memory_order_relaxed);
+        Mixer::total_ns.fetch_add(elapsed, std::memory_order_relaxed);
+        Mixer::last_ns.store(elapsed, std::memory_order_relaxed);
+        if (elapsed > Mixer::max_ns.load(std::memory_order_relaxed)) {
+            Mixer::max_ns.store(elapsed, std::memory_order_relaxed);
+        }
+    }
+
+    Mixer::Statistics Mixer::statistics (void) {
+        return {
+            Mixer::callbacks.load(std::memory_order_relaxed),
+            Mixer::total_ns.load(std::memory_order_relaxed),
+            Mixer::last_ns.load(std::memory_order_relaxed),
+            Mixer::max_ns.load(std::memory_order_relaxed),
+            Mixer::active_voices.load(std::memory_order_relaxed)
+        };
+    }
+
+}
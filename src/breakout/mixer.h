@@ -0,0 +1,91 @@
+#ifndef SRC_BREAKOUT_MIXER_H_
+#define SRC_BREAKOUT_MIXER_H_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include "ring.h"
+
+namespace Breakout {
+
+    // Optional replacement for playing effects through SDL_mixer channels.
+    // Effects are decoded once to 16 bit PCM in the device format and mixed
+    // by the game into the output stream after SDL_mixer (post mix), so the
+    // cost of every voice is known and measured.
+    class Mixer {
+
+    public:
+
+        struct Sample {
+            std::vector<int16_t> pcm;
+            std::size_t frames;
+        };
+
+        struct Statistics {
+            unsigned long callbacks, total_ns, last_ns, max_ns;
+            unsigned voices;
+        };
+
+        static constexpr unsigned MaxVoices = 32;
+
+    private:
+
+        struct Voice {
+            const Sample *sample;
+            unsigned long id;
+            std::size_t position;
+            float gain, target, step;
+            bool active;
+        };
+
+        struct Command {
+            const Sample *sample;
+            unsigned long id;
+            float volume;
+            unsigned fade_ms;
+        };
+
+        static std::vector<std::unique_ptr<Sample>> samples;
+        static Voice voices[MaxVoices];
+        static std::vector<float> accumulator;
+        static Ring<Command, 128> commands;
+        static int frequency, channels;
+        static bool opened, own_device;
+        static unsigned long next_id;
+        static std::atomic<unsigned long> callbacks, total_ns, last_ns, max_ns;
+        static std::atomic<unsigned> active_voices;
+        static std::atomic<std::size_t> sample_bytes;
+
+        static void apply(const Command &command);
+        static void postMix(void *udata, uint8_t *stream, int length);
+
+    public:
+
+        static bool open(void);
+        static void close(void);
+
+        static inline bool isOpen (void) { return Mixer::opened; }
+        static inline int getFrequency (void) { return Mixer::frequency; }
+        static inline int getChannels (void) { return Mixer::channels; }
+
+        // decoded PCM held by every loaded sample
+        static inline std::size_t sampleBytes (void) { return Mixer::sample_bytes.load(std::memory_order_relaxed); }
+
+        static const Sample *load(const std::string &path);
+
+        // game thread only, returns the id used to fade the voice later
+        static unsigned long play(const Sample *sample, int volume);
+        static void fadeOut(unsigned long id, unsigned ms);
+
+        // mixes the active voices into an interleaved 16 bit stream
+        static void mix(int16_t *stream, std::size_t samples);
+
+        static Statistics statistics(void);
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <vector>
+#include "overlay.h"
+#include "memory.h"
+
+namespace Breakout {
+
+    constexpr unsigned Overlay::LabelCount, Overlay::LabelLength;
+    constexpr double Overlay::GraphScale, Overlay::GraphHeight, Overlay::BarWidth, Overlay::NumberSize, Overlay::LabelHeight, Overlay::LabelWidth, Overlay::Depth;
+
+    const char *const Overlay::labels[Overlay::LabelCount] = {
+        "FRAME", "SIM", "RENDER", "DRAWS", "OBJS", "TIMERS", "VOICES", "ALLOCS", "ABYTES", "CONTCT",
+        "HITS", "BONUS", "STATE", "BINDS", "UPLDS", "UBYTES", "IDLE", "BUDGET", "BORDER",
+        "MUSIC", "SFX", "TEXTUR", "STAGES", "BOOKKP"
+    };
+
+    // A to Z, one row of three pixels per value, top row first, 4 is the left pixel
+    static const GLubyte glyphs[26][5] = {
+        { 2, 5, 7, 5, 5 }, { 6, 5, 6, 5, 6 }, { 3, 4, 4, 4, 3 }, { 6, 5, 5, 5, 6 }, { 7, 4, 6, 4, 7 },
+        { 7, 4, 6, 4, 4 }, { 3, 4, 5, 5, 3 }, { 5, 5, 7, 5, 5 }, { 7, 2, 2, 2, 7 }, { 1, 1, 1, 5, 2 },
+        { 5, 5, 6, 5, 5 }, { 4, 4, 4, 4, 7 }, { 5, 7, 7, 5, 5 }, { 6, 5, 5, 5, 5 }, { 2, 5, 5, 5, 2 },
+        { 6, 5, 6, 4, 4 }, { 2, 5, 5, 6, 3 }, { 6, 5, 6, 5, 5 }, { 3, 4, 2, 1, 6 }, { 7, 2, 2, 2, 2 },
+        { 5, 5, 5, 5, 7 }, { 5, 5, 5, 5, 2 }, { 5, 5, 7, 7, 5 }, { 5, 5, 2, 5, 5 }, { 5, 5, 2, 2, 2 },
+        { 7, 1, 2, 4, 7 }
+    };
+
+    GLuint Overlay::label (const char *text) {
+
+        constexpr unsigned width = Overlay::LabelLength * 4, height = 5;
+
+        // rows in image order like the textures loadPNG gives, clear between the letters
+        std::vector<GLubyte> pixels(width * height * 4, 0);
+
+        for (unsigned i = 0; i < Overlay::LabelLength && text[i]; ++i) {
+
+            if (text[i] < 'A' || text[i] > 'Z') {
+                continue;
+            }
+
+            const GLubyte *glyph = glyphs[text[i] - 'A'];
+
+            for (unsigned row = 0; row < height; ++row) {
+                for (unsigned column = 0; column < 3; ++column) {
+                    if (glyph[row] & (4 >> column)) {
+                        GLubyte *pixel = &pixels[(row * width + i * 4 + column) * 4];
+                        pixel[0] = pixel[1] = pixel[2] = 255;
+                        pixel[3] = 200;
+                    }
+                }
+            }
+        }
+
+        GLuint texture;
+
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        Memory::add(Memory::Textures, Memory::textureBytes(texture));
+
+        return texture;
+    }
+
+    Overlay::Overlay (Engine::Window &_window) : window(_window) {
+
+        // one translucent white texel, stretched into every bar
+        const GLubyte texel[] = { 255, 255, 255, 160 };
+
+        glGenTextures(1, &this->texture_bar);
+        glBindTexture(GL_TEXTURE_2D, this->texture_bar);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, texel);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        Memory::add(Memory::Textures, Memory::textureBytes(this->texture_bar));
+
+        for (unsigned i = 0; i < Overlay::LabelCount; ++i) {
+            this->texture_labels[i] = Overlay::label(Overlay::labels[i]);
+        }
+    }
+
+    Overlay::~Overlay (void) {
+        for (GLuint texture : this->texture_labels) {
+            Memory::remove(Memory::Textures, Memory::textureBytes(texture));
+        }
+        glDeleteTextures(Overlay::LabelCount, this->texture_labels);
+        Memory::remove(Memory::Textures, Memory::textureBytes(this->texture_bar));
+        glDeleteTextures(1, &this->texture_bar);
+    }
+
+    void Overlay::render (void) {
+
+        if (!this->visible) {
+            return;
+        }
+
+        double x = -0.96;
+
+        for (unsigned age = 0; age < Stats::History; ++age) {
+            const double height = std::min(Stats::frameTime(age) / Overlay::GraphScale, 1.0) * Overlay::GraphHeight;
+            if (height > 0.0) {
+                this->window.addTexture2D(this->texture_bar, Overlay::BarWidth * 0.75, height, { x, -1.0, Overlay::Depth });
+            }
+            x += Overlay::BarWidth;
+        }
+
+        // the 60 FPS budget
+        this->window.addTexture2D(this->texture_bar, Overlay::BarWidth * Stats::History, 0.004, { -0.96, -1.0 + Overlay::GraphHeight / 2.0, Overlay::Depth });
+
+        double y = 0.75;
+        const double label_x = 0.6 - Overlay::LabelWidth - Overlay::NumberSize * 0.5;
+
+        for (int i = 0; i < Stats::Counter::CounterSize; ++i) {
+            this->window.addTexture2D(this->texture_labels[i], Overlay::LabelWidth, Overlay::LabelHeight, { label_x, y, Overlay::Depth });
+            this->window.drawNumber(Stats::get(static_cast<Stats::Counter>(i)), Overlay::NumberSize, { 0.6, y, Overlay::Depth });
+            y -= Overlay::NumberSize * 1.5;
+        }
+
+        y -= Overlay::NumberSize;
+
+        for (int i = 0; i < Memory::CategorySize; ++i) {
+            this->window.addTexture2D(this->texture_labels[Stats::Counter::CounterSize + i], Overlay::LabelWidth, Overlay::LabelHeight, { label_x, y, Overlay::Depth });
+            this->window.drawNumber(Memory::bytes(static_cast<Memory::Category>(i)) / 1024, Overlay::NumberSize, { 0.6, y, Overlay::Depth });
+            y -= Overlay::NumberSize * 1.5;
+        }
+    }
+
+}
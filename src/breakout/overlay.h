@@ -0,0 +1,63 @@
+#ifndef SRC_BREAKOUT_OVERLAY_H_
+#define SRC_BREAKOUT_OVERLAY_H_
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "stats.h"
+#include "memory.h"
+#include "../engine/window.h"
+
+namespace Breakout {
+
+    // Frame time graph along the bottom and the counters of the last frame
+    // on the right, top to bottom in Stats::Counter order: frame, simulation
+    // and render time in microseconds, draw calls, objects, timers, voices,
+    // allocations, allocated bytes, contacts, hits, bonuses, GL state
+    // changes, texture binds, uploads, upload bytes, the idle time used and
+    // the idle budget in microseconds, then culled brick borders. Below them the
+    // Memory categories in KB. Drawn with the same texture path as the HUD
+    // numbers, each row after a short label from Overlay::labels.
+    class Overlay {
+
+        static constexpr unsigned
+            LabelCount = Stats::Counter::CounterSize + Memory::CategorySize,
+            LabelLength = 6;
+
+        static constexpr double
+            GraphScale = 33333.0,
+            GraphHeight = 0.4,
+            BarWidth = 1.92 / Stats::History,
+            NumberSize = 0.05,
+            // 3x5 glyphs a pixel apart, LabelLength of them per label
+            LabelHeight = 0.03,
+            LabelWidth = LabelHeight * LabelLength * 4 / 5,
+            Depth = 4.5;
+
+        // the counters, then the Memory categories, in the order they are drawn
+        static const char *const labels[LabelCount];
+
+        Engine::Window &window;
+        GLuint texture_bar = 0, texture_labels[LabelCount] = { 0 };
+        bool visible = false;
+
+        // the text in a pixel font, built once so drawing a label is one quad
+        static GLuint label(const char *text);
+
+    public:
+
+        Overlay(Engine::Window &_window);
+        ~Overlay(void);
+
+        Overlay(const Overlay &) = delete;
+        Overlay &operator=(const Overlay &) = delete;
+
+        inline void toggle (void) { this->visible = !this->visible; }
+        inline bool isVisible (void) const { return this->visible; }
+
+        void render(void);
+
+    };
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <memory>
+#include "events.h"
 #include "../engine/mesh.h"
 #include "../engine/window.h"
 #include "../engine/event.h"
@@ -10,7 +11,7 @@
 
 namespace Breakout {
 
-    class Paddler : public Engine::Object {
+    class Paddler : public Engine::Object, public Collidable {
 
         Engine::Window &window;
         const std::valarray<double> start_position;
@@ -25,13 +26,13 @@ namespace Breakout {
         constexpr static double DefaultWidth (void) { return 0.4; }
         constexpr static double DefaultHeight (void) { return 0.05; }
 
-        inline Paddler (Engine::Window &_window, double _max_speed, const std::valarray<double> &_position) : Object(
+        inline Paddler (Engine::Window &_window, Events &_events, double _max_speed, const std::valarray<double> &_position) : Object(
             _position,
             true,
             new Engine::Rectangle2D({ Paddler::DefaultWidth() * -0.5, 0.0, 0.0 }, Paddler::DefaultWidth(), Paddler::DefaultHeight()),
             new Engine::Rectangle2D({ Paddler::DefaultWidth() * -0.5, 0.0, 0.0 }, Paddler::DefaultWidth(), Paddler::DefaultHeight()),
             new Engine::BackgroundColor(Engine::Color::rgba(255, 255, 255, 1.0))
-        ), window(_window), start_position(_position), max_speed(_max_speed), width(Paddler::DefaultWidth()), height(Paddler::DefaultHeight()) {
+        ), Collidable(_events), window(_window), start_position(_position), max_speed(_max_speed), width(Paddler::DefaultWidth()), height(Paddler::DefaultHeight()) {
 
             this->rect_mesh.reset(static_cast<Engine::Rectangle2D *>(this->getMesh()));
             this->rect_collider.reset(static_cast<Engine::Rectangle2D *>(this->getCollider()));
@@ -99,6 +100,8 @@ namespace Breakout {
             this->setPosition(position);
         }
 
+        inline void onRelease (void) { this->destroy(); }
+
         virtual inline std::string getType () const { return "breakout_paddler"; }
 
     };
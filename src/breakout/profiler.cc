@@ -0,0 +1,121 @@
+#include <fstream>
+#include <algorithm>
+#include "profiler.h"
+#include "memory.h"
+
+namespace Breakout {
+
+    constexpr std::size_t Profiler::Capacity;
+    std::mutex Profiler::mutex;
+    std::vector<std::unique_ptr<Profiler::Buffer>> Profiler::buffers;
+    thread_local Profiler::Buffer *Profiler::local = nullptr;
+    thread_local const char *Profiler::zone = nullptr;
+
+    Profiler::Buffer *Profiler::attach (void) {
+        std::lock_guard<std::mutex> lock(Profiler::mutex);
+        // kept until exit, so the zones of finished threads can still be written
+        Profiler::buffers.emplace_back(new Buffer(Profiler::buffers.size() + 1));
+        Memory::add(Memory::Bookkeeping, sizeof(Buffer));
+        Profiler::local = Profiler::buffers.back().get();
+        return Profiler::local;
+    }
+
+    void Profiler::thread (const std::string &name) {
+        Buffer *buffer = Profiler::local ? Profiler::local : Profiler::attach();
+        std::lock_guard<std::mutex> lock(Profiler::mutex);
+        buffer->name = name;
+    }
+
+    static void writeString (std::ostream &out, const std::string &value) {
+        out << '"';
+        for (char c : value) {
+            if (c == '"' || c == '\\') {
+                out << '\\';
+            }
+            out << c;
+        }
+        out << '"';
+    }
+
+    bool Profiler::write (const std::string &path) {
+
+        struct Copy {
+            unsigned id;
+            std::string name;
+            std::vector<Event> events;
+        };
+
+        std::vector<Copy> copies;
+        uint64_t origin = UINT64_MAX;
+
+        {
+            std::lock_guard<std::mutex> lock(Profiler::mutex);
+
+            for (const auto &buffer : Profiler::buffers) {
+
+                const uint64_t head = buffer->head.load(std::memory_order_acquire);
+                uint64_t first = head > Profiler::Capacity ? head - Profiler::Capacity : 0;
+                Copy copy = { buffer->id, buffer->name, {} };
+
+                for (uint64_t i = first; i < head; ++i) {
+                    const Slot &slot = buffer->events[i & (Profiler::Capacity - 1)];
+                    copy.events.push_back({
+                        slot.name.load(std::memory_order_relaxed),
+                        slot.begin.load(std::memory_order_relaxed),
+                        slot.end.load(std::memory_order_relaxed)
+                    });
+                }
+
+                // the owner kept recording while this copied, drop every slot
+                // it claimed since, a slot being written may be torn
+                std::atomic_thread_fence(std::memory_order_acquire);
+                const uint64_t claimed = buffer->claimed.load(std::memory_order_relaxed);
+                if (claimed > Profiler::Capacity && claimed - Profiler::Capacity > first) {
+                    const uint64_t lost = std::min<uint64_t>(claimed - Profiler::Capacity - first, copy.events.size());
+                    copy.events.erase(copy.events.begin(), copy.events.begin() + lost);
+                }
+
+                for (const Event &event : copy.events) {
+                    origin = std::min(origin, event.begin);
+                }
+
+                copies.push_back(std::move(copy));
+            }
+        }
+
+        std::ofstream out(path);
+
+        if (!out) {
+            return false;
+        }
+
+        bool first = true;
+        out << "{\"traceEvents\":[";
+        out.setf(std::ios::fixed);
+        out.precision(3);
+
+        for (const Copy &copy : copies) {
+
+            if (!copy.name.empty()) {
+                out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << copy.id << ",\"args\":{\"name\":";
+                writeString(out, copy.name);
+                out << "}}";
+                first = false;
+            }
+
+            for (const Event &event : copy.events) {
+                out << (first ? "\n" : ",\n") << "{\"name\":";
+                writeString(out, event.name);
+                out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << copy.id
+                    << ",\"ts\":" << (event.begin - origin) / 1000.0
+                    << ",\"dur\":" << (event.end - event.begin) / 1000.0 << "}";
+                first = false;
+            }
+        }
+
+        out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+        return static_cast<bool>(out);
+    }
+
+}
@@ -0,0 +1,111 @@
+#ifndef SRC_BREAKOUT_PROFILER_H_
+#define SRC_BREAKOUT_PROFILER_H_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+// BREAKOUT_ZONE("name") times the rest of the enclosing scope. Without
+// -DBREAKOUT_PROFILE it expands to nothing, the name must be a literal.
+#ifdef BREAKOUT_PROFILE
+#define BREAKOUT_ZONE_NAME(line) breakout_zone_ ## line
+#define BREAKOUT_ZONE_LINE(name, line) Breakout::Profiler::Zone BREAKOUT_ZONE_NAME(line)(name)
+#define BREAKOUT_ZONE(name) BREAKOUT_ZONE_LINE(name, __LINE__)
+#define BREAKOUT_THREAD(name) Breakout::Profiler::thread(name)
+#else
+#define BREAKOUT_ZONE(name) ((void) 0)
+#define BREAKOUT_THREAD(name) ((void) 0)
+#endif
+
+namespace Breakout {
+
+    // Every thread records its zones in a ring of its own, nothing is shared
+    // while recording. The oldest zones are overwritten once a ring is full.
+    class Profiler {
+
+    public:
+
+        static constexpr std::size_t Capacity = 1 << 16;
+
+        struct Event {
+            const char *name;
+            uint64_t begin, end;
+        };
+
+    private:
+
+        // written by the owner while write may copy it, hence the atomics
+        struct Slot {
+            std::atomic<const char *> name;
+            std::atomic<uint64_t> begin, end;
+        };
+
+        // Works as a seqlock: claimed moves before a slot is written and
+        // head after, so write can tell which copied slots were overwritten.
+        struct Buffer {
+            std::atomic<uint64_t> head, claimed;
+            std::string name;
+            unsigned id;
+            Slot events[Profiler::Capacity];
+
+            inline Buffer (unsigned _id) : head(0), claimed(0), id(_id) {}
+        };
+
+        static std::mutex mutex;
+        static std::vector<std::unique_ptr<Buffer>> buffers;
+        static thread_local Buffer *local;
+        static thread_local const char *zone;
+
+        static Buffer *attach(void);
+
+    public:
+
+        class Zone {
+
+            const char *name, *parent;
+            const uint64_t begin;
+
+        public:
+
+            inline Zone (const char *_name) : name(_name), parent(Profiler::zone), begin(Profiler::now()) { Profiler::zone = _name; }
+            inline ~Zone (void) { Profiler::record(this->name, this->begin, Profiler::now()); Profiler::zone = this->parent; }
+
+            Zone(const Zone &) = delete;
+            Zone &operator=(const Zone &) = delete;
+
+        };
+
+        static inline uint64_t now (void) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        static inline void record (const char *name, uint64_t begin, uint64_t end) {
+            Buffer *buffer = Profiler::local ? Profiler::local : Profiler::attach();
+            const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+            Slot &slot = buffer->events[head & (Profiler::Capacity - 1)];
+            buffer->claimed.store(head + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.name.store(name, std::memory_order_relaxed);
+            slot.begin.store(begin, std::memory_order_relaxed);
+            slot.end.store(end, std::memory_order_relaxed);
+            buffer->head.store(head + 1, std::memory_order_release);
+        }
+
+        // innermost zone open on this thread, nullptr outside of any
+        static inline const char *current (void) { return Profiler::zone; }
+
+        // shown as the thread name in the trace
+        static void thread(const std::string &name);
+
+        // Chrome trace event format, open with chrome://tracing or Perfetto
+        static bool write(const std::string &path);
+
+    };
+
+}
+
+#endif
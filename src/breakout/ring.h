@@ -0,0 +1,70 @@
+#ifndef SRC_BREAKOUT_RING_H_
+#define SRC_BREAKOUT_RING_H_
+
+#include <atomic>
+#include <utility>
+#include <cstddef>
+
+namespace Breakout {
+
+    // Lock-free ring buffer for exactly one producer and one consumer thread.
+    template <typename T, std::size_t Size>
+    class Ring {
+
+        static_assert(Size && !(Size & (Size - 1)), "Ring size must be a power of two");
+
+        static constexpr std::size_t Mask = Size - 1;
+
+        T buffer[Size];
+        alignas(64) std::atomic<std::size_t> head;
+        alignas(64) std::atomic<std::size_t> tail;
+
+    public:
+
+        inline Ring (void) : head(0), tail(0) {}
+
+        Ring(const Ring &) = delete;
+        Ring &operator=(const Ring &) = delete;
+
+        // producer side, returns false instead of waiting when full
+        inline bool push (T &&value) {
+            const std::size_t tail = this->tail.load(std::memory_order_relaxed);
+            if (tail - this->head.load(std::memory_order_acquire) == Size) {
+                return false;
+            }
+            this->buffer[tail & Mask] = std::move(value);
+            this->tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        inline bool push (const T &value) {
+            T copy(value);
+            return this->push(std::move(copy));
+        }
+
+        // consumer side, the slot is left moved-from so the producer never
+        // releases anything the consumer still owned
+        inline bool pop (T &value) {
+            const std::size_t head = this->head.load(std::memory_order_relaxed);
+            if (head == this->tail.load(std::memory_order_acquire)) {
+                return false;
+            }
+            value = std::move(this->buffer[head & Mask]);
+            this->buffer[head & Mask] = T();
+            this->head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        inline std::size_t size (void) const {
+            return this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire);
+        }
+
+        inline bool empty (void) const { return this->size() == 0; }
+
+        static constexpr std::size_t capacity (void) { return Size; }
+
+    };
+
+}
+
+#endif
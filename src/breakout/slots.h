@@ -0,0 +1,103 @@
+#ifndef SRC_BREAKOUT_SLOTS_H_
+#define SRC_BREAKOUT_SLOTS_H_
+
+#include <vector>
+#include <cstdint>
+
+namespace Breakout {
+
+    // Index into a Slots array plus the generation it was issued for. A
+    // handle whose slot was removed, or reused since, resolves to nullptr.
+    struct Handle {
+
+        uint32_t index = 0, generation = 0;
+
+        inline bool operator== (const Handle &other) const { return this->index == other.index && this->generation == other.generation; }
+        inline bool operator!= (const Handle &other) const { return !(*this == other); }
+
+        inline explicit operator bool (void) const { return this->generation != 0; }
+
+    };
+
+    template <typename T>
+    class Slots {
+
+        static constexpr uint32_t None = static_cast<uint32_t>(-1);
+
+        struct Slot {
+            T *value;
+            uint32_t generation, next_free;
+        };
+
+        std::vector<Slot> slots;
+        uint32_t free_head = None;
+        std::size_t live = 0;
+
+    public:
+
+        inline Handle insert (T *value) {
+
+            Handle handle;
+
+            if (this->free_head != None) {
+                handle.index = this->free_head;
+                this->free_head = this->slots[handle.index].next_free;
+            } else {
+                handle.index = this->slots.size();
+                this->slots.push_back({ nullptr, 1, None });
+            }
+
+            Slot &slot = this->slots[handle.index];
+
+            slot.value = value;
+            handle.generation = slot.generation;
+            ++this->live;
+
+            return handle;
+        }
+
+        inline T *get (const Handle &handle) const {
+            if (handle.index < this->slots.size()) {
+                const Slot &slot = this->slots[handle.index];
+                if (slot.generation == handle.generation) {
+                    return slot.value;
+                }
+            }
+            return nullptr;
+        }
+
+        inline T *remove (const Handle &handle) {
+
+            T *value = this->get(handle);
+
+            if (value) {
+                Slot &slot = this->slots[handle.index];
+                // generation 0 is never issued, it marks the null handle
+                if (++slot.generation == 0) {
+                    slot.generation = 1;
+                }
+                slot.value = nullptr;
+                slot.next_free = this->free_head;
+                this->free_head = handle.index;
+                --this->live;
+            }
+
+            return value;
+        }
+
+        inline std::size_t size (void) const { return this->live; }
+
+        template <typename F>
+        inline void each (F function) const {
+            for (const auto &slot : this->slots) {
+                if (slot.value) {
+                    function(slot.value);
+                }
+            }
+        }
+
+    };
+
+}
+
+#endif
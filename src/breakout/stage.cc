@@ -4,78 +4,73 @@ namespace Breakout {
 
     Engine::Shader::Program Stage::shader_wave_rotate;
     double Stage::value_wave = 0.0, Stage::value_rotate = 0.0, Stage::time_wave = 0.0;
-    Engine::Audio::Sound Stage::bonus_sounds[static_cast<int>(BonusType::BonusTypeSize)];
+    Effect Stage::bonus_sounds[static_cast<int>(BonusType::BonusTypeSize)] = {
+        { Voices::PriorityBonus, 3.0 }, { Voices::PriorityBonus, 3.0 }, { Voices::PriorityBonus, 3.0 },
+        { Voices::PriorityBonus, 3.0 }, { Voices::PriorityBonus, 3.0 }, { Voices::PriorityBonus, 3.0 }
+    };
+    constexpr int Stage::MaxMusicVolume, Stage::MusicVolumeStep, Stage::MusicCrossfade;
+    constexpr double Stage::ScrollFloor, Stage::ScrollStep, Stage::StreamMargin;
     int Stage::music_volume = 8;
     std::default_random_engine Stage::random_generator(std::chrono::system_clock::now().time_since_epoch().count());
 
     Stage::Stage (
         Engine::Window &_window,
-        const std::string &file
+        const Layout &layout,
+        bool deferred
     ) : window(_window) {
 
-        std::ifstream input(file, std::ios::in);
-
-        if (input.is_open()) {
-
-            bool ok;
-            std::string block, music_path = "audio/themes/";
-            std::stringstream ss(Stage::nextLine(input, ok));
-            double width, height, x, y = 0.9 - (Stage::DefaultVerticalSpace / 2.0);
+        if (layout.loaded) {
 
             this->cleared = false;
 
-            ss >> this->max_speed;
-
-            ss.str(Stage::nextLine(input, ok));
-            ss.seekg(0) >> this->min_speed;
-
-            ss.str(Stage::nextLine(input, ok));
-            ss.seekg(0) >> width;
-
-            ss.str(Stage::nextLine(input, ok));
-            ss.seekg(0) >> height;
-
-            ss.str(Stage::nextLine(input, ok));
-            ss.seekg(0) >> this->ball_x;
-
-            ss.str(Stage::nextLine(input, ok));
-            ss.seekg(0) >> this->ball_y;
-
-            music_path += Stage::nextLine(input, ok);
-
-            this->music.load(music_path);
-            this->music.start(-1);
-            this->music.pause();
-
-            for (std::string line = Stage::nextLine(input, ok); ok; line = Stage::nextLine(input, ok)) {
-
-                x = -1.0 + (Stage::DefaultHorizontalSpace / 2.0);
+            this->max_speed = layout.max_speed;
+            this->min_speed = layout.min_speed;
+            this->ball_x = layout.ball_x;
+            this->ball_y = layout.ball_y;
 
-                ss.str(line);
-                ss.seekg(0);
+            // decoded later by prepare, away from the frame thread
+            this->music_path = "audio/themes/" + layout.music;
 
-                while (ss.good()) {
+            this->rows = layout.rows;
+            this->brick_width = layout.width;
+            this->brick_height = layout.height;
+            this->row_remaining.assign(this->rows.size(), 0);
 
-                    ss >> block;
+            unsigned lives;
 
-                    if (block[0] != '-') {
-                        this->addBrick(block, x, y, width, height);
+            for (std::size_t i = 0; i < this->rows.size(); ++i) {
+                for (const auto &block : this->rows[i]) {
+                    if (block[0] != '-' && Stage::brickOf(block, lives) != BrickKind::BrickNone && lives > 0) {
+                        ++this->row_remaining[i];
                     }
-                    x += width + Stage::DefaultHorizontalSpace;
                 }
-                y -= height + Stage::DefaultVerticalSpace;
+                this->total += this->row_remaining[i];
+                if (this->row_remaining[i]) {
+                    this->lowest_remaining = i + 1;
+                }
             }
 
-            this->destructible = this->can_destroy.size();
+            // a stage taller than the screen starts scrolled to its bottom rows
+            if (this->lowest_remaining) {
+                this->camera = std::max(Stage::ScrollFloor - this->rowY(this->lowest_remaining - 1), 0.0);
+            }
 
-            input.close();
+            // rows far below the view are never built, stream fills the rest from the bottom up
+            this->row_bottom = this->rows.size();
+            while (this->row_bottom && this->rowY(this->row_bottom - 1) < -1.0 - Stage::StreamMargin) {
+                --this->row_bottom;
+            }
+            this->row_top = this->row_bottom;
+            if (!deferred) {
+                this->stream();
+            }
 
             if (!Stage::shader_wave_rotate) {
                 try {
                     Stage::shader_wave_rotate.attachVertexShader({ Engine::Shader::wave_rotate_vertex });
                     Stage::shader_wave_rotate.attachFragmentShader({ Engine::Shader::wave_rotate_fragment });
                 } catch (std::string e) {
-                    std::cerr << e << std::endl;
+                    Log::text(Log::Error, Log::General, e);
                 }
 
                 Stage::shader_wave_rotate.link();
@@ -98,19 +93,165 @@ namespace Breakout {
                 }
             }
         }
+
+        this->accounted.set(this->memory());
+    }
+
+    void Stage::prepare (void) {
+
+        if (!this->music && !this->music_loading && !this->music_path.empty()) {
+
+            const std::string path = this->music_path;
+            const std::shared_ptr<MusicLoad> loading = std::make_shared<MusicLoad>();
+
+            this->music_loading = loading;
+
+            Jobs::background([ path, loading ] () {
+                const std::size_t bytes = Memory::soundBytes(path);
+                // the audio thread may hold the track after the stage is gone
+                std::shared_ptr<Engine::Audio::Sound> music(new Engine::Audio::Sound, [ bytes ] (Engine::Audio::Sound *sound) {
+                    Memory::remove(Memory::Music, bytes);
+                    delete sound;
+                });
+                music->load(path);
+                Memory::add(Memory::Music, bytes);
+                loading->music = std::move(music);
+            }, loading->done);
+        }
     }
 
-    void Stage::start (void) {
+    void Stage::pollMusic (void) {
+
+        if (!this->music_loading || !this->music_loading->done.done()) {
+            return;
+        }
+
+        this->music = std::move(this->music_loading->music);
+        this->music_loading.reset();
 
-        if (this->can_destroy.empty()) {
+        this->postMusic(AudioThread::OperationStart, -1);
+
+        if (this->music_crossfade || !this->window.isPaused()) {
+            // fades in while the previous track fades out in Stage::clear,
+            // or after the player already unpaused a silent start
+            this->postMusic(AudioThread::OperationFadeIn, Stage::music_volume, Stage::MusicCrossfade);
+        } else {
+            this->postMusic(AudioThread::OperationPause);
+            this->postMusic(AudioThread::OperationSetVolume, Stage::music_volume);
+        }
+    }
+
+    void Stage::buildRow (std::size_t row) {
+
+        double x = -1.0 + (Stage::DefaultHorizontalSpace / 2.0);
+        const double y = this->rowY(row);
+        std::vector<Handle> handles;
+
+        for (const auto &block : this->rows[row]) {
+            if (block[0] != '-') {
+                Brick *brick = this->addBrick(block, x, y, this->brick_width, this->brick_height);
+                if (brick) {
+                    brick->setRow(row);
+                    handles.push_back(brick->getHandle());
+                    // rows built during play join the window right away
+                    if (this->ball) {
+                        this->window.addObject(brick);
+                    }
+                }
+            }
+            x += this->brick_width + Stage::DefaultHorizontalSpace;
+        }
+
+        if (row < this->row_top) {
+            this->bricks_by_row.push_front(std::move(handles));
+        } else {
+            this->bricks_by_row.push_back(std::move(handles));
+        }
+    }
+
+    bool Stage::buildStep (void) {
+
+        if (!this->rowPending()) {
+            return false;
+        }
+
+        this->buildRow(this->row_top - 1);
+        --this->row_top;
+        this->accounted.set(this->memory());
+
+        return true;
+    }
+
+    void Stage::stream (void) {
+
+        BREAKOUT_ZONE("stream rows");
+
+        // the camera only moves the rows down, new ones come in above
+        while (this->buildStep()) {}
+
+        // only rows without bricks left to destroy ever scroll out of the view
+        while (this->row_bottom > this->row_top && !this->row_remaining[this->row_bottom - 1] && this->rowY(this->row_bottom - 1) < -1.0 - Stage::StreamMargin) {
+            for (const Handle &handle : this->bricks_by_row.back()) {
+                Brick *brick = static_cast<Brick *>(this->events.get(handle));
+                if (brick) {
+                    Stage::unlist(this->cannot_destroy, brick);
+                    this->released_slots.push_back(Stage::slotOf(brick));
+                    this->events.release(brick);
+                }
+            }
+            this->bricks_by_row.pop_back();
+            --this->row_bottom;
+        }
+
+        this->accounted.set(this->memory());
+    }
+
+    void Stage::scroll (void) {
+
+        if (!this->lowest_remaining || this->window.isPaused()) {
+            return;
+        }
+
+        const double target = std::max(Stage::ScrollFloor - (this->rowY(this->lowest_remaining - 1) - this->camera), 0.0);
+
+        if (this->camera <= target) {
+            return;
+        }
+
+        const double step = std::min(Stage::ScrollStep, this->camera - target);
+
+        this->camera -= step;
+
+        for (std::vector<Brick *> *bricks : { &this->can_destroy, &this->cannot_destroy }) {
+            for (Brick *brick : *bricks) {
+                // same size, the assignment copies into the storage moved already has
+                this->moved = brick->getPosition();
+                this->moved[1] -= step;
+                brick->setPosition(this->moved);
+            }
+        }
+
+        this->stream();
+    }
+
+    void Stage::start (bool crossfade) {
+
+        if (!this->total) {
 
             this->win = true;
 
         } else {
 
-            this->music.setVolume(Stage::music_volume);
+            // rows a deferred stage did not get to in idle time
+            this->stream();
+
+            // the stage starts silent if the track is not decoded yet, the
+            // frame thread only checks on it from update
+            this->prepare();
+            this->music_crossfade = crossfade;
 
             this->window.pause(this->start_pause_context);
+            this->pollMusic();
 
             this->window.eraseEvent<Engine::Event::Keyboard>("keyboard.pause");
             this->window.event<Engine::Event::Keyboard>([ this ] (GLFWwindow *window, int key, int code, int action, int mods) {
@@ -125,19 +266,22 @@ namespace Breakout {
                         }
                     }
 
+                    // the volume is tracked here, asking the sound would wait for the audio thread
                     if (key == GLFW_KEY_MINUS) {
                         if (mods & GLFW_MOD_SHIFT) {
-                            this->music.mute();
+                            Stage::music_volume = 0;
+                            this->postMusic(AudioThread::OperationMute);
                         } else {
-                            Stage::music_volume = this->music.getVolume() - 4;
-                            this->music.setVolume(Stage::music_volume);
+                            Stage::music_volume = std::max(Stage::music_volume - Stage::MusicVolumeStep, 0);
+                            this->postMusic(AudioThread::OperationSetVolume, Stage::music_volume);
                         }
                     } else if (key == GLFW_KEY_EQUAL) {
                         if (mods & GLFW_MOD_SHIFT) {
-                            this->music.maxVolume();
+                            Stage::music_volume = Stage::MaxMusicVolume;
+                            this->postMusic(AudioThread::OperationMaxVolume);
                         } else {
-                            Stage::music_volume = this->music.getVolume() + 4;
-                            this->music.setVolume(Stage::music_volume);
+                            Stage::music_volume = std::min(Stage::music_volume + Stage::MusicVolumeStep, Stage::MaxMusicVolume);
+                            this->postMusic(AudioThread::OperationSetVolume, Stage::music_volume);
                         }
                     }
                 }
@@ -151,18 +295,18 @@ namespace Breakout {
                     if (key == GLFW_MOUSE_BUTTON_LEFT) {
                         if (this->window.isPaused()) {
                             this->window.unpause(this->start_pause_context);
-                            this->music.play();
+                            this->postMusic(AudioThread::OperationPlay);
                             this->debug_mode = false;
                             this->debug_last_status = false;
                             this->debug_status = false;
                         } else {
                             this->window.pause(this->start_pause_context);
-                            this->music.pause();
+                            this->postMusic(AudioThread::OperationPause);
                         }
                     } else if (key == GLFW_MOUSE_BUTTON_RIGHT) {
                         if (!this->window.isPaused()) {
                             this->window.pause(this->start_pause_context);
-                            this->music.pause();
+                            this->postMusic(AudioThread::OperationPause);
                         }
                         this->debug_mode = true;
                         this->debug_status = !this->debug_status;
@@ -170,18 +314,12 @@ namespace Breakout {
                 }
             }, "mouseclick.pause");
 
-            this->ball = new Ball(this->max_speed, this->min_speed, [ this ] () {
-
-                if (this->lives > 1) {
-                    this->reset();
-                    --this->lives;
-                } else {
-                    this->loss = true;
-                }
+            Ball *ball = new Ball(this->events, this->max_speed, this->min_speed, { this->ball_x, this->ball_y, 4.0 });
 
-            }, { this->ball_x, this->ball_y, 4.0 });
+            Paddler *paddler = new Paddler(this->window, this->events, this->max_speed / 1.5, { 0.0, -0.9, 4.0 });
 
-            this->paddler = new Paddler(this->window, this->max_speed / 1.5, { 0.0, -0.9, 4.0 });
+            this->ball = ball->getHandle();
+            this->paddler = paddler->getHandle();
 
             for (auto &brick : this->can_destroy) {
                 this->window.addObject(brick);
@@ -191,9 +329,9 @@ namespace Breakout {
                 this->window.addObject(brick);
             }
 
-            this->window.addObject(this->ball);
-            this->window.addObject(this->paddler);
-            this->ball->start();
+            this->window.addObject(ball);
+            this->window.addObject(paddler);
+            ball->start();
         }
     }
 
@@ -208,26 +346,47 @@ namespace Breakout {
         this->window.eraseEvent<Engine::Event::Keyboard>("keyboard.pause");
         this->window.eraseEvent<Engine::Event::MouseClick>("mouseclick.pause");
 
+        this->events.clear();
+
         if (!this->cleared) {
 
             this->cleared = true;
 
             if (this->ball) {
 
-                this->music.fadeOut(1000);
+                this->postMusic(AudioThread::OperationFadeOut, Stage::MusicCrossfade);
 
-                this->ball->destroy();
-                this->paddler->destroy();
+                this->events.release(this->getBall());
+                this->events.release(this->getPaddler());
 
                 for (auto &brick : this->can_destroy) {
-                    brick->destroy();
+                    this->events.release(brick);
                 }
 
                 for (auto &brick : this->cannot_destroy) {
-                    brick->destroy();
+                    this->events.release(brick);
+                }
+
+                this->events.collect();
+
+            } else {
+
+                // never started, the window does not know about these bricks
+                for (auto &brick : this->can_destroy) {
+                    delete brick;
                 }
 
+                for (auto &brick : this->cannot_destroy) {
+                    delete brick;
+                }
             }
+
+            this->can_destroy.clear();
+            this->cannot_destroy.clear();
+            this->bricks_by_row.clear();
+            // the arena is released with the stage, the slots are not reused
+            this->released_slots.clear();
+            this->destroyed_slots.clear();
         }
 
         this->window.unpause(this->start_pause_context);
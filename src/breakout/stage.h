@@ -2,15 +2,25 @@
 #define SRC_BREAKOUT_STAGE_H_
 
 #include <iostream>
-#include <fstream>
-#include <sstream>
+#include <algorithm>
 #include <memory>
 #include <unordered_map>
 #include <random>
 #include <chrono>
+#include <sstream>
+#include <deque>
 #include "brick.h"
 #include "ball.h"
 #include "paddler.h"
+#include "events.h"
+#include "arena.h"
+#include "voices.h"
+#include "audiothread.h"
+#include "layout.h"
+#include "profiler.h"
+#include "log.h"
+#include "memory.h"
+#include "jobs.h"
 #include "../engine/window.h"
 #include "../engine/audio.h"
 #include "../engine/shader.h"
@@ -36,25 +46,58 @@ namespace Breakout {
         static Engine::Shader::Program shader_wave_rotate;
         static double value_wave, value_rotate, time_wave;
         static bool active_wave, active_rotate;
-        static Engine::Audio::Sound bonus_sounds[];
+        static Effect bonus_sounds[];
         static int music_volume;
         static std::default_random_engine random_generator;
 
-        Engine::Audio::Sound music;
+        // declared first so it is released after everything that points into it
+        Arena arena;
+        Memory::Account accounted{ Memory::Stages };
+        std::string music_path;
+        std::shared_ptr<Engine::Audio::Sound> music;
+        // shared with the decoding job, a stage deleted before it finishes just lets go
+        struct MusicLoad {
+            Jobs::Counter done;
+            std::shared_ptr<Engine::Audio::Sound> music;
+        };
+        std::shared_ptr<MusicLoad> music_loading;
         Engine::Window &window;
-        std::unordered_set<Brick *> can_destroy, cannot_destroy;
-        Ball *ball = nullptr;
-        Paddler *paddler = nullptr;
+        Events events;
+        // dense, a destroyed brick is swapped with the last one
+        std::vector<Brick *> can_destroy, cannot_destroy;
+        // Rows are only built while they are near the view. The camera is
+        // added to the height of every row, the rows in [row_top, row_bottom)
+        // exist and bricks_by_row holds their bricks in the same order.
+        std::vector<std::vector<std::string>> rows;
+        std::vector<unsigned> row_remaining;
+        std::deque<std::vector<Handle>> bricks_by_row;
+        std::size_t row_top = 0, row_bottom = 0, lowest_remaining = 0, total = 0;
+        double camera = 0.0, brick_width = 0.0, brick_height = 0.0;
+        // What a released brick leaves in the arena. The window deletes the
+        // brick on its first update after Events::collect destroyed it, only
+        // then the slots go back to the arena for the rows built later.
+        struct Slot {
+            void *brick;
+            std::size_t size;
+            Engine::Rectangle2D *mesh, *collider;
+            Engine::BackgroundColor *background;
+        };
+        std::vector<Slot> released_slots, destroyed_slots;
+        // reused by scroll, so moving the bricks never allocates
+        std::valarray<double> moved = std::valarray<double>(3);
+        Handle ball, paddler;
         std::vector<unsigned> timeouts[static_cast<int>(BonusType::BonusTypeSize)] = { { } };
         bool
             cleared = true,
             win = false,
+            // the track is faded in over the previous one once it is decoded
+            music_crossfade = false,
             loss = false,
             debug_mode = false,
             debug_status = false,
             debug_last_status = false,
             active_bonuses[static_cast<int>(BonusType::BonusTypeSize)] = { false };
-        unsigned start_pause_context, destructible, rotate_pause_context = 0, lives = 3;
+        unsigned start_pause_context, destroyed = 0, rotate_pause_context = 0, lives = 3;
         double min_speed, max_speed, ball_x, ball_y;
 
         void clearBonusTimeouts (const BonusType type) {
@@ -136,83 +179,162 @@ namespace Breakout {
             }
         }
 
-        static inline bool not_space (int c) {
-        	return !isspace(c);
+        static inline void unlist (std::vector<Brick *> &bricks, Brick *brick) {
+            Brick *last = bricks.back();
+            bricks[brick->getIndex()] = last;
+            last->setIndex(brick->getIndex());
+            bricks.pop_back();
         }
 
-        static inline std::string &ltrim (std::string &s) {
-        	s.erase(s.begin(), find_if(s.begin(), s.end(), not_space));
-        	return s;
+        static inline Slot slotOf (Brick *brick) {
+            return {
+                brick, brick->footprint(),
+                static_cast<Engine::Rectangle2D *>(brick->getMesh()),
+                static_cast<Engine::Rectangle2D *>(brick->getCollider()),
+                static_cast<Engine::BackgroundColor *>(brick->getBackground())
+            };
         }
 
-        static inline std::string &rtrim (std::string &s) {
-        	s.erase(find_if(s.rbegin(), s.rend(), not_space).base(), s.end());
-        	return s;
+        inline void recycle (void) {
+            for (const Slot &slot : this->destroyed_slots) {
+                this->arena.recycle(slot.brick, slot.size);
+                this->arena.dispose(slot.mesh);
+                this->arena.dispose(slot.collider);
+                this->arena.dispose(slot.background);
+            }
+            this->destroyed_slots.clear();
         }
 
-        static inline std::string &trim (std::string &s) {
-        	return ltrim(rtrim(s));
+        inline void removeDestructible (Brick *brick) {
+            Stage::unlist(this->can_destroy, brick);
+            ++this->destroyed;
+            --this->row_remaining[brick->getRow()];
+            while (this->lowest_remaining && !this->row_remaining[this->lowest_remaining - 1]) {
+                --this->lowest_remaining;
+            }
         }
 
-        static std::string nextLine (
-        	std::istream &in,
-            bool &ok
-        ) {
-        	std::string line = "";
-        	do {
-        		std::getline(in, line);
-        		line = line.substr(0, line.find_first_of('>'));
-        	} while (!trim(line).size() && in.good());
+        enum BrickKind : int {
+            BrickNone = 0,
+            BrickNormal = 1,
+            BrickBonus = 2,
+            BrickAbstract = 3
+        };
 
-            ok = line.size() > 0;
+        // class and lives of the brick a layout token makes, 0 lives cannot be destroyed
+        static inline BrickKind brickOf (const std::string &id, unsigned &lives) {
+            const unsigned type = std::stoul(id.substr(0, id.find_first_of('#')));
+            if (type < 4) {
+                lives = type;
+                return BrickKind::BrickNormal;
+            } else if (type < 7) {
+                lives = type - 3;
+                return BrickKind::BrickBonus;
+            } else if (type <= 8) {
+                lives = type - 7;
+                return BrickKind::BrickAbstract;
+            }
+            lives = 0;
+            return BrickKind::BrickNone;
+        }
 
-        	return line;
+        inline double rowY (std::size_t row) const {
+            return 0.9 - (Stage::DefaultVerticalSpace / 2.0) - row * (this->brick_height + Stage::DefaultVerticalSpace) + this->camera;
         }
 
-        Brick *createBrickByID (Engine::Window &window, const std::string &id, const double x, const double y, const double width, const double height) {
+        // the row above the built ones is still short of the view
+        inline bool rowPending (void) const {
+            return this->row_top && this->rowY(this->row_top - 1) <= 1.0 + Stage::StreamMargin;
+        }
 
-            unsigned divisor = id.find_first_of('#'), type = stoul(id.substr(0, divisor));
-            Brick *brick = nullptr;
-            std::function<void(Brick *)> on_destroy = [ this ] (Brick *destroyed) {
-                this->can_destroy.erase(destroyed);
-            };
+        void buildRow(std::size_t row);
+        void stream(void);
+        void scroll(void);
 
-            Engine::BackgroundColor *bg = new Engine::BackgroundColor(Engine::Color::hex(id.substr(divisor)));
+        // a track still being decoded has nothing to play, pause or fade yet
+        inline void postMusic (AudioThread::Operation operation, int value = 0, int duration = 0) {
+            if (this->music) {
+                AudioThread::post(operation, this->music, value, duration);
+            }
+        }
 
-            if (type < 4) {
-                brick = new Brick(window, { x, y, 4.0 }, bg, on_destroy, width, height, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, type);
-            } else if (type < 7) {
-                brick = new BonusBrick(window, { x, y, 4.0 }, bg, [=] (void) {
+        // starts the track once its decoding job is done, never waits for it
+        void pollMusic(void);
+
+        // every brick and ball reports here, called for each report of the tick
+        inline void onReport (Events::Report report, Collidable *source) {
+            switch (report) {
+                case Events::ReportDestroyed:
+                    this->removeDestructible(static_cast<Brick *>(source));
+                    this->released_slots.push_back(Stage::slotOf(static_cast<Brick *>(source)));
+                break;
+                case Events::ReportBonus: {
                     std::uniform_int_distribution<int> rand(0, BonusType::BonusTypeSize - 1);
                     this->activateBonus(static_cast<BonusType>(rand(Stage::random_generator)));
-                }, on_destroy, width, height, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, type - 3);
-            } else if (type <= 8) {
-                brick = new AbstractBrick(window, { x, y, 4.0 }, bg, on_destroy, width, height, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, type - 7);
+                }
+                break;
+                case Events::ReportTouchBottom:
+                    if (this->lives > 1) {
+                        this->reset();
+                        --this->lives;
+                    } else {
+                        this->loss = true;
+                    }
+                break;
             }
+        }
 
-            return brick;
+        Brick *createBrickByID (Engine::Window &window, const std::string &id, const double x, const double y, const double width, const double height) {
+
+            unsigned lives;
+            const BrickKind kind = Stage::brickOf(id, lives);
+
+            if (kind == BrickKind::BrickNone) {
+                return nullptr;
+            }
+
+            Engine::BackgroundColor *bg = this->arena.make<Engine::BackgroundColor>(Engine::Color::hex(id.substr(id.find_first_of('#'))));
+
+            switch (kind) {
+                case BrickKind::BrickBonus:
+                    return new (this->arena) BonusBrick(window, this->events, this->arena, { x, y, 4.0 }, bg, width, height, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, lives);
+                case BrickKind::BrickAbstract:
+                    return new (this->arena) AbstractBrick(window, this->events, this->arena, { x, y, 4.0 }, bg, width, height, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, lives);
+                default:
+                    return new (this->arena) Brick(window, this->events, this->arena, { x, y, 4.0 }, bg, width, height, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, lives);
+            }
         }
 
     public:
 
         static constexpr double DefaultVerticalSpace = 0.01, DefaultHorizontalSpace = 0.01;
+        // the camera keeps the lowest row with bricks left to destroy at or
+        // above ScrollFloor, rows are built and retired StreamMargin outside the view
+        static constexpr double ScrollFloor = -0.2, ScrollStep = 0.005, StreamMargin = 0.25;
+        static constexpr int MaxMusicVolume = 128, MusicVolumeStep = 4, MusicCrossfade = 1000;
 
+        // deferred leaves the rows to buildStep, start builds whatever is left
         Stage (
             Engine::Window &_window,
-            const std::string &file
+            const Layout &layout,
+            bool deferred = false
         );
 
         inline ~Stage (void) { this->clear(); }
 
-        void start(void);
+        void prepare(void);
+        // builds one more row of the view, false once they all exist
+        bool buildStep(void);
+        inline bool isBuilt (void) const { return !this->rowPending(); }
+        void start(bool crossfade = false);
         void clear(void);
 
         void debugInfo (std::ostream &out) {
             out << "Paddler:" << std::endl;
-            this->paddler->debugInfo(out, " ");
+            this->getPaddler()->debugInfo(out, " ");
 
             out << "Ball:" << std::endl;
-            this->ball->debugInfo(out, " ");
+            this->getBall()->debugInfo(out, " ");
 
             out << "Indestructible bricks:" << std::endl;
             for (const auto &brick : this->cannot_destroy) {
@@ -227,23 +349,34 @@ namespace Breakout {
 
         void update (void) {
 
-            static GLuint heart_texture = loadPNG("images/life.png");
-            double x = 0.7;
-            this->window.drawNumber(this->destructible - this->can_destroy.size(), 0.15, { -1.0, 0.85, 4.0 });
+            BREAKOUT_ZONE("stage update");
 
-            for (unsigned i = 0; i < this->lives; ++i) {
-                this->window.addTexture2D(heart_texture, 0.1, 0.1, { x, 0.88, 4.0 });
-                x += 0.1;
-            }
+            // the window deleted the bricks destroyed by the last collect
+            this->recycle();
+
+            this->pollMusic();
+
+            this->events.dispatch();
+            this->events.notify([ this ] (Events::Report report, Collidable *source) {
+                this->onReport(report, source);
+            });
+            this->events.collect();
+            this->destroyed_slots.swap(this->released_slots);
 
-            if (this->can_destroy.empty()) {
+            this->scroll();
+
+            if (this->destroyed == this->total) {
                 this->clear();
                 this->win = true;
             }
             if (this->debug_mode) {
                 if (this->debug_last_status != this->debug_status) {
                     this->debug_last_status = this->debug_status;
-                    this->debugInfo(std::cout);
+                    if (Log::enabled(Log::Debug, Log::Game)) {
+                        std::ostringstream info;
+                        this->debugInfo(info);
+                        Log::text(Log::Debug, Log::Game, info.str());
+                    }
                     this->window.unpause(this->start_pause_context);
                 } else {
                     this->window.pause(this->start_pause_context);
@@ -251,27 +384,56 @@ namespace Breakout {
             }
         }
 
+        inline unsigned destroyedCount (void) const { return this->destroyed; }
+        inline unsigned livesLeft (void) const { return this->lives; }
+
+        // the bonus effects, read while drawing
+        static inline double waveValue (void) { return Stage::value_wave; }
+        static inline double rotateValue (void) { return Stage::value_rotate; }
+
+        inline std::size_t objects (void) const { return this->events.size(); }
+        inline std::size_t memory (void) const {
+            return this->arena.capacity() + (this->can_destroy.capacity() + this->cannot_destroy.capacity()) * sizeof(Brick *);
+        }
+        inline std::size_t contacts (void) const { return this->events.contactCount(); }
+        inline std::size_t hits (void) const { return this->events.hitCount(); }
+
+        inline std::size_t bonuses (void) const {
+            return std::count(std::begin(this->active_bonuses), std::end(this->active_bonuses), true);
+        }
+
+        // timeouts scheduled by the bonuses still running
+        inline std::size_t timers (void) const {
+            std::size_t count = 0;
+            for (int i = 0; i < static_cast<int>(BonusType::BonusTypeSize); ++i) {
+                if (this->active_bonuses[i]) {
+                    count += this->timeouts[i].size();
+                }
+            }
+            return count;
+        }
+
         inline bool isClear (void) const { return this->cleared; }
         inline bool won (void) const { return this->win; }
         inline bool lost (void) const { return this->loss; }
 
-        inline void reset (void) { this->window.pause(this->start_pause_context); this->ball->stop(), this->ball->start(), this->paddler->stop(), this->paddler->start(); }
+        inline void reset (void) { this->window.pause(this->start_pause_context); this->getBall()->stop(), this->getBall()->start(), this->getPaddler()->stop(), this->getPaddler()->start(); }
 
-        inline void addBrick (const std::string &id, double x, double y, double width, double height) {
+        inline Brick *addBrick (const std::string &id, double x, double y, double width, double height) {
 
             Brick *brick = Stage::createBrickByID(this->window, id, x, y, width, height);
 
             if (brick) {
-                if (brick->isDestructible()) {
-                    this->can_destroy.insert(brick);
-                } else {
-                    this->cannot_destroy.insert(brick);
-                }
+                std::vector<Brick *> &bricks = brick->isDestructible() ? this->can_destroy : this->cannot_destroy;
+                brick->setIndex(bricks.size());
+                bricks.push_back(brick);
             }
+
+            return brick;
         }
 
-        Ball *getBall (void) const { return this->ball; }
-        Paddler *getPaddler (void) const { return this->paddler; }
+        Ball *getBall (void) const { return static_cast<Ball *>(this->events.get(this->ball)); }
+        Paddler *getPaddler (void) const { return static_cast<Paddler *>(this->events.get(this->paddler)); }
 
         inline Engine::Window &getWindow (void) const { return this->window; }
 
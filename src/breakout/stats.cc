@@ -0,0 +1,21 @@
+#include "stats.h"
+
+namespace Breakout {
+
+    constexpr unsigned Stats::History;
+    std::atomic<uint64_t> Stats::values[Stats::Counter::CounterSize];
+    uint64_t Stats::last[Stats::Counter::CounterSize] = { 0 };
+    float Stats::history[Stats::History] = { 0.0f };
+    unsigned Stats::history_head = 0;
+
+    void Stats::frame (void) {
+
+        for (int i = 0; i < Stats::Counter::CounterSize; ++i) {
+            Stats::last[i] = Stats::values[i].exchange(0, std::memory_order_relaxed);
+        }
+
+        Stats::history[Stats::history_head] = Stats::last[Stats::Counter::FrameTime];
+        Stats::history_head = (Stats::history_head + 1) % Stats::History;
+    }
+
+}
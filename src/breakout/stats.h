@@ -0,0 +1,67 @@
+#ifndef SRC_BREAKOUT_STATS_H_
+#define SRC_BREAKOUT_STATS_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace Breakout {
+
+    // Per frame counters shown by the overlay and exported by Metrics. Written from any thread,
+    // main.cc closes the frame with Stats::frame once everything ran.
+    class Stats {
+
+    public:
+
+        enum Counter : int {
+            FrameTime = 0,
+            SimulationTime = 1,
+            RenderTime = 2,
+            DrawCalls = 3,
+            Objects = 4,
+            Timers = 5,
+            AudioVoices = 6,
+            Allocations = 7,
+            AllocatedBytes = 8,
+            Contacts = 9,
+            Hits = 10,
+            Bonuses = 11,
+            StateChanges = 12,
+            TextureBinds = 13,
+            Uploads = 14,
+            UploadBytes = 15,
+            IdleTime = 16,
+            IdleBudget = 17,
+            CulledBorders = 18,
+
+            CounterSize = 19
+        };
+
+        // frame times kept for the graph
+        static constexpr unsigned History = 120;
+
+    private:
+
+        static std::atomic<uint64_t> values[Counter::CounterSize];
+        static uint64_t last[Counter::CounterSize];
+        static float history[Stats::History];
+        static unsigned history_head;
+
+    public:
+
+        static inline void set (Counter counter, uint64_t value) { Stats::values[counter].store(value, std::memory_order_relaxed); }
+        static inline void add (Counter counter, uint64_t value = 1) { Stats::values[counter].fetch_add(value, std::memory_order_relaxed); }
+
+        // value of the frame that just ended
+        static inline uint64_t get (Counter counter) { return Stats::last[counter]; }
+
+        // frameTime(0) is the oldest frame kept, in microseconds
+        static inline float frameTime (unsigned age) { return Stats::history[(Stats::history_head + age) % Stats::History]; }
+
+        // latches every counter and starts counting the next frame from zero
+        static void frame(void);
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include "voices.h"
+#include "profiler.h"
+
+namespace Breakout {
+
+    std::vector<Effect *> Voices::requested;
+    std::vector<Voices::Voice> Voices::active;
+    unsigned Voices::max_voices = 6;
+
+    void Voices::request (Effect *effect) {
+        Voices::requested.push_back(effect);
+    }
+
+    void Voices::update (void) {
+
+        BREAKOUT_ZONE("voices");
+
+        const double now = Voices::now();
+
+        Voices::active.erase(std::remove_if(Voices::active.begin(), Voices::active.end(), [ now ] (const Voice &voice) {
+            return voice.until <= now;
+        }), Voices::active.end());
+
+        if (Voices::requested.empty()) {
+            return;
+        }
+
+        std::stable_sort(Voices::requested.begin(), Voices::requested.end(), [] (const Effect *a, const Effect *b) {
+            return a->priority > b->priority;
+        });
+
+        for (Effect *effect : Voices::requested) {
+
+            effect->requested = false;
+
+            if (now - effect->last_start < effect->interval) {
+                continue;
+            }
+
+            if (Voices::active.size() >= Voices::max_voices) {
+
+                // steal the oldest voice among the ones with the lowest priority
+                auto victim = std::min_element(Voices::active.begin(), Voices::active.end(), [] (const Voice &a, const Voice &b) {
+                    if (a.effect->priority != b.effect->priority) {
+                        return a.effect->priority < b.effect->priority;
+                    }
+                    return a.start < b.start;
+                });
+
+                if (victim == Voices::active.end() || victim->effect->priority >= effect->priority) {
+                    continue;
+                }
+
+                if (victim->mixer_id) {
+                    Mixer::fadeOut(victim->mixer_id, Voices::StealFadeOut);
+                } else {
+                    AudioThread::post(AudioThread::OperationFadeOut, victim->effect->sound, Voices::StealFadeOut);
+                }
+                Voices::active.erase(victim);
+            }
+
+            unsigned long mixer_id = 0;
+
+            if (effect->sample) {
+                mixer_id = Mixer::play(effect->sample, effect->volume);
+            } else {
+                AudioThread::post(AudioThread::OperationPlay, effect->sound);
+            }
+
+            effect->last_start = now;
+            Voices::active.push_back({ effect, now, now + effect->length, mixer_id });
+        }
+
+        Voices::requested.clear();
+    }
+
+    void Voices::clear (void) {
+        for (Effect *effect : Voices::requested) {
+            effect->requested = false;
+        }
+        Voices::requested.clear();
+        Voices::active.clear();
+    }
+
+}
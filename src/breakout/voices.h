@@ -0,0 +1,106 @@
+#ifndef SRC_BREAKOUT_VOICES_H_
+#define SRC_BREAKOUT_VOICES_H_
+
+#include <string>
+#include <vector>
+#include <limits>
+#include <chrono>
+#include "audiothread.h"
+#include "mixer.h"
+#include "memory.h"
+#include "../engine/audio.h"
+
+namespace Breakout {
+
+    class Effect;
+
+    // Keeps the number of simultaneous effects bounded. Triggers are only
+    // recorded during the frame and started together by Voices::update.
+    class Voices {
+
+        struct Voice {
+            Effect *effect;
+            double start, until;
+            unsigned long mixer_id;
+        };
+
+        static std::vector<Effect *> requested;
+        static std::vector<Voice> active;
+        static unsigned max_voices;
+
+    public:
+
+        enum Priority : int {
+            PriorityEffect = 0,
+            PriorityBonus = 1,
+            PriorityJingle = 2
+        };
+
+        static constexpr int StealFadeOut = 50, MaxVolume = 128;
+
+        static inline double now (void) {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        static inline void setMaxVoices (unsigned _max_voices) { Voices::max_voices = _max_voices; }
+        static inline unsigned getMaxVoices (void) { return Voices::max_voices; }
+        static inline unsigned activeVoices (void) { return Voices::active.size(); }
+
+        static void request(Effect *effect);
+        static void update(void);
+        static void clear(void);
+
+    };
+
+    class Effect {
+
+        friend class Voices;
+
+        Engine::Audio::Sound sound;
+        const Mixer::Sample *sample = nullptr;
+        const Voices::Priority priority;
+        const double length, interval;
+        double last_start = -std::numeric_limits<double>::infinity();
+        int volume = Voices::MaxVolume;
+        bool requested = false, loaded = false;
+
+    public:
+
+        inline Effect (Voices::Priority _priority = Voices::PriorityEffect, double _length = 0.5, double _interval = 0.0)
+        : priority(_priority), length(_length), interval(_interval) {}
+
+        // decoded by the engine side mixer when it is enabled
+        inline void load (const std::string &path) {
+            if (Mixer::isOpen()) {
+                this->sample = Mixer::load(path);
+            }
+            if (!this->sample) {
+                this->sound.load(path);
+                Memory::add(Memory::Effects, Memory::soundBytes(path));
+            }
+            this->loaded = true;
+        }
+        inline bool isLoaded (void) const { return this->loaded; }
+
+        inline void setVolume (int _volume) {
+            this->volume = _volume;
+            if (!this->sample) {
+                AudioThread::post(AudioThread::OperationSetVolume, this->sound, _volume);
+            }
+        }
+
+        // several triggers in the same frame start a single voice
+        inline void play (void) {
+            if (!this->requested) {
+                this->requested = true;
+                Voices::request(this);
+            }
+        }
+
+        inline Voices::Priority getPriority (void) const { return this->priority; }
+
+    };
+
+}
+
+#endif
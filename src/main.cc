@@ -1,17 +1,98 @@
 #include <memory>
 #include <iostream>
+#include <cstdlib>
+#include <sstream>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include "engine/window.h"
 #include "breakout/game.h"
+#include "breakout/audiothread.h"
+#include "breakout/mixer.h"
+#include "breakout/jobs.h"
+#include "breakout/profiler.h"
+#include "breakout/stats.h"
+#include "breakout/overlay.h"
+#include "breakout/allocations.h"
+#include "breakout/metrics.h"
+#include "breakout/glstats.h"
+#include "breakout/log.h"
+#include "breakout/memory.h"
+#include "breakout/idle.h"
 
 #define WINDOW_FPS 60
+#define PROFILE_TRACE "breakout.trace.json"
+#define ALLOCATION_WARMUP 300
 
 int main (int argc, char **argv) {
 
-    if (argc < 2) {
+    std::vector<std::string> stages;
+    bool use_mixer = false, forbid_allocations = false, endless = false;
+    unsigned long endless_seed = 0;
+    std::string metrics_path;
+    double metrics_interval = Breakout::Metrics::DefaultInterval;
+    unsigned long max_draw_calls = 0, over_budget = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--mixer") {
+            use_mixer = true;
+        } else if (arg == "--forbid-allocations") {
+            forbid_allocations = true;
+        } else if (arg == "--endless") {
+            // the seed is optional, stage files can follow
+            endless = true;
+            char *end;
+            if (i + 1 < argc) {
+                const unsigned long seed = std::strtoul(argv[i + 1], &end, 10);
+                if (*argv[i + 1] && !*end) {
+                    endless_seed = seed;
+                    ++i;
+                }
+            }
+        } else if (arg == "--metrics" && i + 1 < argc) {
+            metrics_path = argv[++i];
+        } else if (arg == "--metrics-interval" && i + 1 < argc) {
+            metrics_interval = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--max-draw-calls" && i + 1 < argc) {
+            max_draw_calls = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--log-level" && i + 1 < argc) {
+            Breakout::Log::Level level;
+            if (!Breakout::Log::parseLevel(argv[++i], level)) {
+                std::cerr << "ERROR: Unknown log level " << argv[i] << std::endl;
+                return -1;
+            }
+            Breakout::Log::setLevel(level);
+        } else if (arg == "--log-debug" && i + 1 < argc) {
+            // comma separated categories logged down to debug
+            std::istringstream names(argv[++i]);
+            std::string name;
+            while (std::getline(names, name, ',')) {
+                Breakout::Log::Category category;
+                if (!Breakout::Log::parseCategory(name, category)) {
+                    std::cerr << "ERROR: Unknown log category " << name << std::endl;
+                    return -1;
+                }
+                Breakout::Log::setLevel(category, Breakout::Log::Debug);
+            }
+        } else {
+            stages.push_back(arg);
+        }
+    }
+
+    if (stages.empty() && !endless) {
         std::cerr << "You should pass the name of the stage(s) via terminal in order." << std::endl;
         std::cerr << "Example: $ bin/tp1 ../stages/level_00.brk" << std::endl;
+        std::cerr << "Or play generated stages: $ bin/tp1 --endless [seed]" << std::endl;
+        return -1;
+    }
+
+    if (forbid_allocations && !Breakout::Allocations::enabled()) {
+        std::cerr << "ERROR: --forbid-allocations needs a build with ALLOCATIONS=1" << std::endl;
+        return -1;
+    }
+
+    if (max_draw_calls && !Breakout::GLStats::enabled()) {
+        std::cerr << "ERROR: --max-draw-calls needs a build with GLSTATS=1" << std::endl;
         return -1;
     }
 
@@ -24,8 +105,6 @@ int main (int argc, char **argv) {
 
     if (window) {
 
-        std::vector<std::string> stages;
-
         window.makeCurrentContext();
 
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -47,15 +126,51 @@ int main (int argc, char **argv) {
 
         glDisable(GL_LIGHTING);
 
-        for (int i = 1; i < argc; ++i) {
-            stages.push_back(argv[i]);
+        BREAKOUT_THREAD("main");
+
+        Breakout::Log::start(std::clog);
+        Breakout::Jobs::start();
+        Breakout::AudioThread::start();
+
+        if (use_mixer && !Breakout::Mixer::open()) {
+            std::cerr << "ERROR: Could not open the software mixer, using SDL_mixer channels" << std::endl;
+        }
+
+        if (!metrics_path.empty() && !Breakout::Metrics::start(metrics_path, metrics_interval)) {
+            std::cerr << "ERROR: Could not open " << metrics_path << " for metrics" << std::endl;
         }
 
-        Breakout::Game game(window, stages);
+        Breakout::Game game(window, stages, endless ? new Breakout::Endless(endless_seed) : nullptr);
 
         game.start();
 
+        Breakout::Overlay overlay(window);
+
+        window.event<Engine::Event::Keyboard>([ &overlay ] (GLFWwindow *window, int key, int code, int action, int mods) {
+            if (action == GLFW_PRESS) {
+                if (key == GLFW_KEY_F3) {
+                    overlay.toggle();
+                } else if (key == GLFW_KEY_F4) {
+                    std::ostringstream report;
+                    Breakout::Memory::report(report);
+                    Breakout::Log::text(Breakout::Log::Info, Breakout::Log::Performance, report.str());
+                }
+#ifdef BREAKOUT_PROFILE
+                if (key == GLFW_KEY_F12) {
+                    Breakout::Profiler::write(PROFILE_TRACE);
+                }
+#endif
+            }
+        }, "keyboard.main");
+
+        uint64_t frame_start = Breakout::Profiler::now();
+        unsigned long frame_count = 0;
+
         while (!window.shouldClose()) {
+            // steady state on the main thread only, the audio and job threads are not checked
+            Breakout::Allocations::forbid(forbid_allocations && ++frame_count > ALLOCATION_WARMUP);
+
+            BREAKOUT_ZONE("frame");
             int width, height;
 
             window.getFramebufferSize(width, height);
@@ -72,30 +187,100 @@ int main (int argc, char **argv) {
 
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-            window.draw();
-            window.update();
-
-            window.swapBuffers();
-            glClear(0);
-            glfwPollEvents();
+            uint64_t render_start = Breakout::Profiler::now();
+            {
+                BREAKOUT_ZONE("draw");
+                game.render();
+                overlay.render();
+                window.draw();
+            }
+            uint64_t simulation_start = Breakout::Profiler::now();
+            {
+                BREAKOUT_ZONE("window update");
+                window.update();
+            }
+            uint64_t simulation_time = Breakout::Profiler::now() - simulation_start;
+            {
+                BREAKOUT_ZONE("swap buffers");
+                window.swapBuffers();
+                glClear(0);
+            }
+            uint64_t render_time = Breakout::Profiler::now() - render_start - simulation_time;
+            {
+                BREAKOUT_ZONE("poll events");
+                glfwPollEvents();
+            }
 
+            simulation_start = Breakout::Profiler::now();
             game.update();
+            simulation_time += Breakout::Profiler::now() - simulation_start;
+
+            Breakout::Idle::run(frame_start + 1000000000ull / WINDOW_FPS);
 
-            unsigned fps = window.sync(WINDOW_FPS);
+            unsigned fps;
+            {
+                BREAKOUT_ZONE("sync");
+                fps = window.sync(WINDOW_FPS);
+            }
             if (fps != WINDOW_FPS) {
-                std::cout << fps << " FPS" << std::endl;
+                BREAKOUT_LOG(Info, Performance, "{} FPS", fps);
             }
+
+            const uint64_t frame_end = Breakout::Profiler::now();
+            Breakout::Stats::set(Breakout::Stats::FrameTime, (frame_end - frame_start) / 1000);
+            Breakout::Stats::set(Breakout::Stats::SimulationTime, simulation_time / 1000);
+            Breakout::Stats::set(Breakout::Stats::RenderTime, render_time / 1000);
+            Breakout::Stats::frame();
+            Breakout::Metrics::frame();
+
+            if (max_draw_calls && Breakout::Stats::get(Breakout::Stats::DrawCalls) > max_draw_calls) {
+                ++over_budget;
+            }
+            frame_start = frame_end;
         }
 
+        Breakout::Allocations::forbid(false);
+
+        Breakout::Memory::report(std::cout);
+
         game.clear();
         window.update();
 
+        Breakout::Metrics::stop();
+        Breakout::AudioThread::stop();
+
+        if (Breakout::Mixer::isOpen()) {
+            const Breakout::Mixer::Statistics mixer = Breakout::Mixer::statistics();
+            if (mixer.callbacks) {
+                std::cout << "Mixer: " << mixer.callbacks << " callbacks, "
+                    << (mixer.total_ns / mixer.callbacks) / 1000.0 << " us avg, "
+                    << mixer.max_ns / 1000.0 << " us max" << std::endl;
+            }
+            Breakout::Mixer::close();
+        }
+
+        Breakout::Jobs::stop();
+        Breakout::Log::stop();
+
+#ifdef BREAKOUT_PROFILE
+        Breakout::Profiler::write(PROFILE_TRACE);
+#endif
+
+        if (Breakout::Allocations::enabled()) {
+            Breakout::Allocations::report(std::cout);
+        }
         Engine::Audio::End();
     } else {
         std::cerr << "ERROR: Could not initialize window" << std::endl;
     }
     glfwTerminate();
 
+    // lets automated runs fail on a render efficiency regression
+    if (over_budget) {
+        std::cerr << "ERROR: " << over_budget << " frames went over " << max_draw_calls << " draw calls" << std::endl;
+        return 1;
+    }
+
     return 0;
 
 }
@@ -0,0 +1,201 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include "../breakout/jobs.h"
+
+using Breakout::Jobs;
+
+static unsigned failures = 0;
+
+static void expect (bool condition, const std::string &what) {
+    if (!condition) {
+        std::cerr << "FAIL: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// every task runs once and wait returns only after all of them
+static void testRun (void) {
+
+    std::atomic<unsigned> count(0);
+    Jobs::Counter done;
+
+    for (unsigned i = 0; i < 1000; ++i) {
+        Jobs::run([ &count ] () { count.fetch_add(1); }, done);
+    }
+
+    Jobs::wait(done);
+
+    expect(done.done(), "run: counter reaches zero");
+    expect(count.load() == 1000, "run: every task runs once");
+}
+
+// each link of the chain starts only after the previous one finished
+static void testChain (void) {
+
+    constexpr unsigned length = 64;
+
+    std::atomic<unsigned> step(0);
+    std::atomic<bool> ordered(true);
+    std::vector<std::unique_ptr<Jobs::Counter>> links;
+
+    for (unsigned i = 0; i < length; ++i) {
+        links.emplace_back(new Jobs::Counter);
+    }
+
+    auto link = [ &step, &ordered ] (unsigned i) {
+        return [ &step, &ordered, i ] () {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            if (step.fetch_add(1) != i) {
+                ordered.store(false);
+            }
+        };
+    };
+
+    Jobs::run(link(0), *links[0]);
+
+    for (unsigned i = 1; i < length; ++i) {
+        Jobs::run(link(i), *links[i], *links[i - 1]);
+    }
+
+    Jobs::wait(*links[length - 1]);
+
+    expect(ordered.load(), "chain: dependencies run in order");
+    expect(step.load() == length, "chain: every link runs");
+}
+
+// a task scheduled after an already finished counter is not held back
+static void testFinishedDependency (void) {
+
+    Jobs::Counter first, second;
+    std::atomic<bool> ran(false);
+
+    Jobs::run([] () {}, first);
+    Jobs::wait(first);
+
+    Jobs::run([ &ran ] () { ran.store(true); }, second, first);
+    Jobs::wait(second);
+
+    expect(ran.load(), "dependency: finished counter releases at once");
+}
+
+// the chunks cover the range exactly once
+static void testParallelFor (void) {
+
+    constexpr std::size_t size = 10007;
+
+    std::vector<std::atomic<unsigned>> hits(size);
+
+    for (auto &hit : hits) {
+        hit.store(0);
+    }
+
+    Jobs::parallelFor(0, size, 64, [ &hits ] (std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            hits[i].fetch_add(1);
+        }
+    });
+
+    bool once = true;
+
+    for (auto &hit : hits) {
+        once = once && hit.load() == 1;
+    }
+
+    expect(once, "parallelFor: every index is visited once");
+}
+
+// background work never runs on the thread that waits for it
+static void testBackground (void) {
+
+    const std::thread::id caller = std::this_thread::get_id();
+    std::atomic<bool> elsewhere(false);
+    Jobs::Counter done;
+
+    Jobs::background([ &elsewhere, caller ] () {
+        elsewhere.store(std::this_thread::get_id() != caller);
+    }, done);
+
+    Jobs::wait(done);
+
+    expect(elsewhere.load(), "background: runs on a worker thread");
+}
+
+// tasks and continuations still pending at shutdown all run before stop returns
+static void testStop (void) {
+
+    constexpr unsigned length = 32;
+
+    std::atomic<unsigned> count(0);
+    std::vector<std::unique_ptr<Jobs::Counter>> links;
+
+    for (unsigned i = 0; i < length; ++i) {
+        links.emplace_back(new Jobs::Counter);
+    }
+
+    Jobs::start(4);
+
+    Jobs::background([ &count ] () {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        count.fetch_add(1);
+    }, *links[0]);
+
+    for (unsigned i = 1; i < length; ++i) {
+        Jobs::run([ &count ] () { count.fetch_add(1); }, *links[i], *links[i - 1]);
+    }
+
+    // a fan out from the head keeps several continuations pending at once
+    Jobs::Counter fan;
+
+    for (unsigned i = 0; i < length; ++i) {
+        Jobs::run([ &count ] () { count.fetch_add(1); }, fan, *links[0]);
+    }
+
+    Jobs::stop();
+
+    expect(!Jobs::isRunning(), "stop: scheduler is stopped");
+    expect(count.load() == 2 * length, "stop: pending continuations run");
+    expect(links[length - 1]->done() && fan.done(), "stop: counters reach zero");
+}
+
+// without a running scheduler the work runs inline
+static void testStopped (void) {
+
+    Jobs::Counter done;
+    bool ran = false;
+
+    Jobs::run([ &ran ] () { ran = true; }, done);
+
+    expect(ran && done.done(), "stopped: run executes inline");
+}
+
+int main (void) {
+
+    Jobs::start();
+
+    testRun();
+    testChain();
+    testFinishedDependency();
+    testParallelFor();
+    testBackground();
+
+    Jobs::stop();
+
+    for (unsigned i = 0; i < 50; ++i) {
+        testStop();
+    }
+
+    testStopped();
+
+    if (failures) {
+        std::cerr << failures << " failure(s)" << std::endl;
+        return 1;
+    }
+
+    std::cout << "jobs: all tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include <iostream>
+#include <string>
+#include "../breakout/layout.h"
+
+int main (int argc, char **argv) {
+
+    unsigned format = 2;
+    std::string input, output;
+
+    for (int i = 1; i < argc; ++i) {
+
+        const std::string arg = argv[i];
+
+        if (arg == "--v1") {
+            format = 1;
+        } else if (arg == "--v2") {
+            format = 2;
+        } else if (input.empty()) {
+            input = arg;
+        } else if (output.empty()) {
+            output = arg;
+        } else {
+            std::cerr << "ERROR: Unexpected argument " << arg << std::endl;
+            return -1;
+        }
+    }
+
+    if (output.empty()) {
+        std::cerr << "Usage: bin/convert [--v1 | --v2] input.brk output.brk" << std::endl;
+        return -1;
+    }
+
+    Breakout::Layout layout;
+
+    if (!layout.load(input)) {
+        std::cerr << "ERROR: Could not read " << input << std::endl;
+        return -1;
+    }
+
+    if (!layout.save(output, format)) {
+        std::cerr << "ERROR: Could not write " << output << std::endl;
+        return -1;
+    }
+
+    return 0;
+
+}
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <cstdlib>
+#include "../breakout/generator.h"
+
+int main (int argc, char **argv) {
+
+    Breakout::Generator::Options options;
+    std::string output;
+
+    for (int i = 1; i < argc; ++i) {
+
+        const std::string arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (arg.compare(0, 2, "--") != 0) {
+            output = arg;
+            continue;
+        }
+
+        if (arg == "--tall") {
+            options.tall = true;
+            continue;
+        }
+
+        if (!value) {
+            std::cerr << "ERROR: " << arg << " needs a value" << std::endl;
+            return -1;
+        }
+
+        ++i;
+
+        if (arg == "--rows") {
+            options.rows = std::strtoul(value, nullptr, 10);
+        } else if (arg == "--columns") {
+            options.columns = std::strtoul(value, nullptr, 10);
+        } else if (arg == "--palette") {
+            options.palette = std::strtoul(value, nullptr, 10);
+        } else if (arg == "--indestructible") {
+            options.indestructible = std::strtod(value, nullptr);
+        } else if (arg == "--normal") {
+            options.normal = std::strtod(value, nullptr);
+        } else if (arg == "--bonus") {
+            options.bonus = std::strtod(value, nullptr);
+        } else if (arg == "--abstract") {
+            options.abstract = std::strtod(value, nullptr);
+        } else if (arg == "--seed") {
+            options.seed = std::strtoul(value, nullptr, 10);
+        } else if (arg == "--music") {
+            options.music = value;
+        } else {
+            std::cerr << "ERROR: Unknown option " << arg << std::endl;
+            return -1;
+        }
+    }
+
+    if (output.empty()) {
+        std::cerr << "Usage: bin/generate [--rows N] [--columns N] [--palette N] [--indestructible RATIO]" << std::endl;
+        std::cerr << "    [--normal W] [--bonus W] [--abstract W] [--seed N] [--music FILE] [--tall] output.brk" << std::endl;
+        return -1;
+    }
+
+    if (!Breakout::Generator::generate(options).save(output)) {
+        std::cerr << "ERROR: Could not write " << output << std::endl;
+        return -1;
+    }
+
+    return 0;
+
+}